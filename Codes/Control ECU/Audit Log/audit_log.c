@@ -0,0 +1,259 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	audit_log.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Audit Log, events are staged in RAM and written to an
+					EEPROM ring one page of records at a time
+------------------------------------------------------------------------------*/
+#include "audit_log.h"
+#include "../Frame Protocol/frame.h"
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+/* Packed records waiting to be written, oldest first */
+static uint8 g_staging[AUDIT_STAGING_SIZE][AUDIT_RECORD_SIZE];
+static uint8 g_stagedCount=0;
+/* Page being written by the EEPROM driver in the background */
+static uint8 g_page[EEPROM_PAGE_SIZE];
+/* Staged records in the page being written, 0 if no page is written. They
+ * leave the staging buffer only once the write succeeds */
+static uint8 g_writeCount=0;
+/* Set by the TWI ISR when the page write ends */
+static volatile bool g_writeDone=FALSE;
+static volatile uint8 g_writeResult;
+/* A failed page is written again with the next event, not at once, so a
+ * dead EEPROM does not keep the bus busy */
+static bool g_writeFailed=FALSE;
+/* Page being read by the EEPROM driver in the background */
+static uint8 g_readPage[EEPROM_PAGE_SIZE];
+static volatile bool g_readDone=TRUE;
+static volatile uint8 g_readResult;
+/* Newest page when the reading started */
+static uint8 g_readSlot;
+/* Slot and sequence of the newest page */
+static uint8 g_slot=AUDIT_PAGES-1;
+static uint8 g_sequence=0xFF;
+/* Events dropped as the staging buffer was full */
+static uint16 g_droppedCount=0;
+static void (*g_callBackPtr)(void) = NULL_PTR;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes(Private)                          *
+ ------------------------------------------------------------------------------*/
+/* Function responsible for writing the first count staged records */
+static uint8 AUDIT_writePage(uint8 count);
+/* Function responsible for calculating the CRC of a page */
+static uint8 AUDIT_crc(const uint8 *page);
+/* Function responsible for the EEPROM address of a slot */
+static uint16 AUDIT_address(uint8 slot);
+/* Function responsible for unpacking count records */
+static void AUDIT_unpack(const uint8 *packed,uint8 count,\
+		Audit_RecordType *records);
+/* Completion callbacks of the page writes and reads, called from the TWI
+ * ISR */
+static void AUDIT_writeDone(uint8 result);
+static void AUDIT_readDone(uint8 result);
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+void AUDIT_init(void){
+	uint8 page[EEPROM_PAGE_SIZE];
+	uint8 slot;
+	bool found=FALSE;
+	g_stagedCount=0;
+	g_writeCount=0;
+	/*Keep the valid page with the newest sequence, the next page is
+	 *written after it*/
+	for(slot=0;slot<AUDIT_PAGES;slot++){
+		if(EEPROM_readBlock(AUDIT_address(slot),page,EEPROM_PAGE_SIZE)!=SUCCESS){
+			continue;
+		}
+		if(page[EEPROM_PAGE_SIZE-2]!=AUDIT_crc(page)){
+			continue;
+		}
+		if((!found)||((sint8)(page[0]-g_sequence)>0)){
+			g_sequence=page[0];
+			g_slot=slot;
+			found=TRUE;
+		}
+	}
+}
+
+void AUDIT_log(uint8 type,uint8 panel,uint32 time){
+	uint8 *record;
+	g_writeFailed=FALSE;
+	if(g_stagedCount==AUDIT_STAGING_SIZE){
+		/*Both staged pages are full, a written page frees one. Otherwise the
+		 *event is dropped rather than waiting for the EEPROM*/
+		AUDIT_process();
+		if(g_stagedCount==AUDIT_STAGING_SIZE){
+			g_droppedCount++;
+			return;
+		}
+	}
+	if(time>AUDIT_MAX_TIME){
+		time=AUDIT_MAX_TIME;
+	}
+	record=g_staging[g_stagedCount];
+	record[0]=(uint8)((type<<4)|(panel&0x0F));
+	record[1]=(uint8)time;
+	record[2]=(uint8)(time>>8);
+	record[3]=(uint8)(time>>16);
+	g_stagedCount++;
+	AUDIT_process();
+}
+
+uint8 AUDIT_process(void){
+	uint8 i,j;
+	if((g_writeCount!=0)&&g_writeDone){
+		if(g_writeResult==SUCCESS){
+			/*The page is in the EEPROM, remove its records from the staging
+			 *buffer*/
+			g_slot=(g_slot+1)%AUDIT_PAGES;
+			g_sequence++;
+			for(i=g_writeCount;i<g_stagedCount;i++){
+				for(j=0;j<AUDIT_RECORD_SIZE;j++){
+					g_staging[i-g_writeCount][j]=g_staging[i][j];
+				}
+			}
+			g_stagedCount-=g_writeCount;
+		}
+		else{
+			/*A failed page keeps its records and is written again to the
+			 *same slot*/
+			g_writeFailed=TRUE;
+		}
+		g_writeCount=0;
+	}
+	if(g_stagedCount<AUDIT_RECORDS_PER_PAGE){
+		return SUCCESS;
+	}
+	/*One EEPROM write cycle for a whole page of events*/
+	if((g_writeCount!=0)||g_writeFailed||EEPROM_isBusy()){
+		return ERROR;
+	}
+	return AUDIT_writePage(AUDIT_RECORDS_PER_PAGE);
+}
+
+void AUDIT_setCallBack(void(*a_ptr)(void)){
+	g_callBackPtr=a_ptr;
+}
+
+void AUDIT_startRead(void){
+	g_readSlot=g_slot;
+}
+
+uint8 AUDIT_readPage(uint8 index){
+	if(!g_readDone){
+		return ERROR;
+	}
+	g_readDone=FALSE;
+	/*The oldest page is the one after the newest*/
+	if(EEPROM_readBlockAsync(AUDIT_address((g_readSlot+1+index)%AUDIT_PAGES),\
+			g_readPage,EEPROM_PAGE_SIZE,AUDIT_readDone)==ERROR){
+		g_readDone=TRUE;
+		return ERROR;
+	}
+	return SUCCESS;
+}
+
+bool AUDIT_isReadDone(void){
+	return g_readDone;
+}
+
+uint8 AUDIT_getPage(Audit_RecordType *records){
+	if((g_readResult!=SUCCESS)||\
+			(g_readPage[EEPROM_PAGE_SIZE-2]!=AUDIT_crc(g_readPage))||\
+			(g_readPage[1]>AUDIT_RECORDS_PER_PAGE)){
+		return 0;
+	}
+	AUDIT_unpack(&g_readPage[2],g_readPage[1],records);
+	return g_readPage[1];
+}
+
+uint8 AUDIT_getStaged(uint8 index,Audit_RecordType *records){
+	uint8 first=index*AUDIT_RECORDS_PER_PAGE;
+	uint8 count;
+	if(first>=g_stagedCount){
+		return 0;
+	}
+	count=g_stagedCount-first;
+	if(count>AUDIT_RECORDS_PER_PAGE){
+		count=AUDIT_RECORDS_PER_PAGE;
+	}
+	AUDIT_unpack(g_staging[first],count,records);
+	return count;
+}
+
+uint16 AUDIT_getDropped(void){
+	return g_droppedCount;
+}
+
+static uint8 AUDIT_writePage(uint8 count){
+	uint8 i,j;
+	g_page[0]=g_sequence+1;
+	g_page[1]=count;
+	for(i=0;i<AUDIT_RECORDS_PER_PAGE;i++){
+		for(j=0;j<AUDIT_RECORD_SIZE;j++){
+			g_page[2+(i*AUDIT_RECORD_SIZE)+j]=(i<count) ? g_staging[i][j] : 0;
+		}
+	}
+	g_page[EEPROM_PAGE_SIZE-2]=AUDIT_crc(g_page);
+	g_page[EEPROM_PAGE_SIZE-1]=0;
+	/*The page is written in the background while new events are staged, the
+	 *slot moves on once the write succeeds*/
+	g_writeDone=FALSE;
+	if(EEPROM_writeBlockAsync(AUDIT_address((g_slot+1)%AUDIT_PAGES),g_page,\
+			EEPROM_PAGE_SIZE,AUDIT_writeDone)==ERROR){
+		return ERROR;
+	}
+	g_writeCount=count;
+	return SUCCESS;
+}
+
+static uint8 AUDIT_crc(const uint8 *page){
+	uint8 i;
+	uint8 crc=AUDIT_CRC_INITIAL;
+	for(i=0;i<EEPROM_PAGE_SIZE-2;i++){
+		crc=FRAME_crc8(crc,page[i]);
+	}
+	return crc;
+}
+
+static uint16 AUDIT_address(uint8 slot){
+	return AUDIT_REGION_ADDRESS+((uint16)slot*EEPROM_PAGE_SIZE);
+}
+
+static void AUDIT_unpack(const uint8 *packed,uint8 count,\
+		Audit_RecordType *records){
+	uint8 i;
+	for(i=0;i<count;i++){
+		records[i].type=packed[0]>>4;
+		records[i].panel=packed[0]&0x0F;
+		records[i].time=((uint32)packed[1])|((uint32)packed[2]<<8)|\
+				((uint32)packed[3]<<16);
+		packed+=AUDIT_RECORD_SIZE;
+	}
+}
+
+static void AUDIT_writeDone(uint8 result){
+	/*The result is kept by AUDIT_process out of the ISR*/
+	g_writeResult=result;
+	g_writeDone=TRUE;
+	if(g_callBackPtr!=NULL_PTR){
+		(*g_callBackPtr)();
+	}
+}
+
+static void AUDIT_readDone(uint8 result){
+	g_readResult=result;
+	g_readDone=TRUE;
+	if(g_callBackPtr!=NULL_PTR){
+		(*g_callBackPtr)();
+	}
+}
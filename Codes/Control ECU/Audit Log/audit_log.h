@@ -0,0 +1,99 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	audit_log.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Header File for the Audit Log, a ring of event records in
+					the external EEPROM written in page batches
+------------------------------------------------------------------------------*/
+
+#ifndef AUDIT_LOG_H
+#define AUDIT_LOG_H
+
+#include "../Important Heading Files/std_types.h"
+#include "../External EEPROM/external_eeprom.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Preprocessor Macros                                    *
+ ------------------------------------------------------------------------------*/
+/*-------------------------- Page Description ----------------------------------
+ * | SEQUENCE | COUNT | RECORDS (AUDIT_RECORDS_PER_PAGE x 4 bytes) | CRC-8 | 0 |
+ * SEQUENCE : Incremented by every page, the newest page has the sequence
+ *            which is ahead of all others (modulo 256)
+ * COUNT    : Number of used records, a page can be flushed before it is full
+ * RECORD   : | TYPE (high nibble) PANEL (low nibble) | TIME (24-bit, LSB first) |
+ * CRC-8    : FRAME_crc8 over SEQUENCE, COUNT and RECORDS starting from
+ *            AUDIT_CRC_INITIAL, so erased and torn pages are skipped
+ * The pages are written round-robin over AUDIT_PAGES, the oldest page is
+ * overwritten when the region is full.
+ -----------------------------------------------------------------------------*/
+#define AUDIT_RECORD_SIZE 4
+#define AUDIT_RECORDS_PER_PAGE 3
+#define AUDIT_CRC_INITIAL 0xFF
+/* Region reserved for the log, the second 1 KB of the EEPROM */
+#define AUDIT_REGION_ADDRESS 0x0400
+#define AUDIT_PAGES 64
+/* Records kept in RAM until a full page can be written, two pages so new
+ * events are staged while the last page is written */
+#define AUDIT_STAGING_SIZE (2*AUDIT_RECORDS_PER_PAGE)
+/* The time is saved in 24 bits */
+#define AUDIT_MAX_TIME 0x00FFFFFFUL
+
+#if ((AUDIT_RECORDS_PER_PAGE*AUDIT_RECORD_SIZE)+3 > EEPROM_PAGE_SIZE)
+#error "The audit records do not fit in one EEPROM page"
+#endif
+#if (AUDIT_PAGES > 127)
+#error "AUDIT_PAGES must be less than half the sequence range"
+#endif
+
+/* -----------------------------------------------------------------------------
+ *                         Types Declaration                                   *
+ ------------------------------------------------------------------------------*/
+typedef enum{
+	AUDIT_DOOR_OPENED=1,AUDIT_WRONG_PASSWORD,AUDIT_LOCKOUT,AUDIT_PASSWORD_SET,\
+	AUDIT_PASSWORD_CHANGED
+}Audit_EventType;
+
+typedef struct{
+	uint8 type;
+	uint8 panel;
+	uint32 time;
+}Audit_RecordType;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes                                   *
+ ------------------------------------------------------------------------------*/
+/* Find the newest page, it needs EEPROM_init and the I-bit */
+void AUDIT_init(void);
+/* Stage an event, the type and panel must be less than 16. The event is
+ * dropped and counted if both staged pages are still waiting for the
+ * EEPROM, it never blocks */
+void AUDIT_log(uint8 type,uint8 panel,uint32 time);
+/* Keep the page written by the last write or retry it if the write failed,
+ * then start writing the next full staged page if the EEPROM is free. It
+ * returns ERROR if a full page is waiting but the EEPROM is busy, it never
+ * blocks */
+uint8 AUDIT_process(void);
+/* Function called from the TWI ISR when a page write or read ends, so the
+ * next staged page can be written */
+void AUDIT_setCallBack(void(*a_ptr)(void));
+/* Keep the newest page, the pages read by AUDIT_readPage are counted from
+ * the oldest page at this call */
+void AUDIT_startRead(void);
+/* Start reading the page at index in the background, returns ERROR if the
+ * EEPROM is busy */
+uint8 AUDIT_readPage(uint8 index);
+/* Returns TRUE once the page read started by AUDIT_readPage ends */
+bool AUDIT_isReadDone(void);
+/* Decode the page read, returns its number of records or 0 if the page is
+ * empty, corrupted or the read failed */
+uint8 AUDIT_getPage(Audit_RecordType *records);
+/* Copy the staged page at index (0 is the oldest), returns its number of
+ * records, the events which are not written yet */
+uint8 AUDIT_getStaged(uint8 index,Audit_RecordType *records);
+/* Returns the number of events dropped since boot */
+uint16 AUDIT_getDropped(void);
+
+#endif
@@ -9,232 +9,1020 @@
 					responsible for the system operations and control.
 ------------------------------------------------------------------------------*/
 
-#define F_CPU 8000000UL
 #include "DC Motor Driver/dc_motor.h"
+#include "End Stop/end_stop.h"
 #include "External EEPROM/external_eeprom.h"
-#include "Timer 1/timer1.h"
+#include "I2C/i2c.h"
+#include "Software Timer/sw_timer.h"
+#include "Scheduler/scheduler.h"
+#include "Power Manager/power.h"
 #include "UART/uart.h"
+#include "Frame Protocol/frame.h"
+#include "Credential Store/credential_store.h"
+#include "Audit Log/audit_log.h"
+#include "Trace/trace.h"
 
-/* Random number to check if the control ECU is ready to receive
- * password or not*/
-#define CONTROL_ECU_READY 0xF0
-/* Global Variable to store the state of 2 passwords; matched or not*/
-volatile uint8 g_matchingCheck;
-/* Global Variable to store the number of seconds counted by timer 1*/
-volatile uint8 g_seconds=0;
+/* Size of the password arrays including the terminator (13)*/
+#define PASSWORD_SIZE CREDENTIAL_PASSWORD_SIZE
+/* Global Variables to store the received password and the second password
+ * or the saved one*/
+uint8 g_password[PASSWORD_SIZE];
+uint8 g_password_2[PASSWORD_SIZE];
+/* The TWI timeouts are measured by a periodic software timer*/
+#if (TWI_TICK_MS%SWTIMER_TICK_MS != 0)
+#error "TWI_TICK_MS must be a multiple of SWTIMER_TICK_MS"
+#endif
+/* Global Variable to call TWI_tick every TWI_TICK_MS*/
+Swtimer_Type g_twiTimer;
+/* Global Variable to count the ticks since boot for the power statistics*/
+Swtimer_Type g_powerTimer;
+/* Global Variable to time out the frames which stop in the middle*/
+Swtimer_Type g_frameTimer;
+/* Global Variable to time the buzzer*/
+Swtimer_Type g_lockoutTimer;
+/* Global Variable to read the end stops of the doors without an external
+ * interrupt every tick*/
+Swtimer_Type g_endStopTimer;
+/*Events posted by the ISRs to the main loop*/
+enum{EVENT_UART_RX,EVENT_TIMER,EVENT_EEPROM_DONE,EVENT_DOOR,\
+	EVENT_TWI_RECOVER,EVENT_FRAME_SENT};
+/*Software timers, latched as bits until EVENT_TIMER is handled*/
+enum{TIMER_LOCKOUT,TIMER_SESSION,TIMER_PROBE};
+/*Door events, latched as bits in the door until its EVENT_DOOR is handled.
+ *The end stops are the bits 1<<ENDSTOP_OPEN and 1<<ENDSTOP_CLOSED*/
+#define DOOR_EVENT_TIMER (1<<2)
+/* Global Variables to latch the expired timers and post one EVENT_TIMER for
+ * all of them before it is handled*/
+volatile uint8 g_timerEvents=0;
+volatile bool g_timerEventPending=FALSE;
+/* Global Variables to post one EVENT_EEPROM_DONE and one EVENT_TWI_RECOVER
+ * at a time*/
+volatile bool g_eepromEventPending=FALSE;
+volatile bool g_twiEventPending=FALSE;
+/* Global Variable to post one EVENT_UART_RX for all the bytes received
+ * before it is handled*/
+volatile bool g_rxEventPending=FALSE;
+/* Global Variable to post one EVENT_FRAME_SENT for all the frames sent
+ * before it is handled*/
+volatile bool g_txEventPending=FALSE;
 /*2 Passwords States*/
 enum{UNMATCHED=1,MATCHED=2};
 /*Door States*/
-enum{OPEN,CHANGE,RESET,OPENED,CLOSED,CLOSING,DONE};
+enum{OPEN,CHANGE,RESET,OPENED,CLOSED,CLOSING,DONE,BUSY,OPENING,FAULT};
+/*Door Commands, the payload of FRAME_DOOR*/
+enum{COMMAND_OPEN,COMMAND_EXTEND_HOLD,COMMAND_STOP};
+/*States of the door state machine*/
+enum{DOOR_CLOSED,DOOR_OPENING,DOOR_OPEN_HOLD,DOOR_CLOSING,DOOR_FAULT};
+/*Time of the soft start and stop of the door motor*/
+#define DOOR_RAMP_MS 500
+/*The door stops at its end stops, these times only limit a move which
+ *misses them*/
+#define DOOR_TRAVEL_TIMEOUT_S 15
+#define DOOR_HOLD_S 3
+#define DOOR_EXTEND_S 10
+/* Doors driven by the controller, each one with its motor, end stops and
+ * state machine. Door 0 uses OC2 and the door 1 OC1B; a third door uses OC1A
+ * (PD5) so the direction pins of door 0 move from PD5/PD6 to PB0/PB1. Panel i
+ * opens door i%DOORS_NUMBER, so a third door needs a third panel*/
+#define DOORS_NUMBER 2
+#if (DOORS_NUMBER < 1) || (DOORS_NUMBER > ENDSTOP_DOORS)
+#error "DOORS_NUMBER must be 1 to ENDSTOP_DOORS"
+#endif
+/*Each source has one event waiting at most; UART RX, frame sent, timers,
+ *EEPROM, TWI and one per door, so SCHED_post never fails*/
+#if (5+DOORS_NUMBER > SCHED_QUEUE_SIZE)
+#error "SCHED_QUEUE_SIZE must hold one event per source"
+#endif
+/* Wrong passwords before the buzzer is activated*/
+#define MAX_ATTEMPTS 3
+/* Addresses of the HMI panels on the UART multi-processor bus*/
+#define PANELS_NUMBER 2
+#define INSIDE_PANEL_ADDRESS 0x01
+#define OUTSIDE_PANEL_ADDRESS 0x02
+#define THIRD_PANEL_ADDRESS 0x03
+#if (PANELS_NUMBER < 1) || (PANELS_NUMBER > 3)
+#error "PANELS_NUMBER must be 1 to 3"
+#endif
+#if (DOORS_NUMBER > PANELS_NUMBER)
+#error "Every door is opened from its own panel, raise PANELS_NUMBER"
+#endif
+#if (PANELS_NUMBER > FRAME_LAST_FRAMES)
+#error "The frame protocol must keep the last frame of every panel"
+#endif
+/* Time given to each panel to offer its baud rates at boot, a panel which
+ * does not answer is absent and the others are served without it*/
+#define PANEL_OFFER_TIMEOUT_MS 200
+/* Time given to the panels to acknowledge the selected baud rate at it,
+ * otherwise all ECUs go back to UART_DEFAULT_BAUD*/
+#define BAUD_ACK_TIMEOUT_MS 200
+#if (PANELS_NUMBER > 8)
+#error "The baud rate acknowledges are tracked in 8 bits"
+#endif
+/* Period of FRAME_READY sent to the absent panels until they answer*/
+#define PANEL_PROBE_MS 1000
+/* Time without any frame from the panel of the active session before the
+ * session ends, a panel which left in the middle of a command*/
+#define SESSION_TIMEOUT_S 30
+/*Panel Session States, the frame or the timer each session waits for*/
+enum{SESSION_IDLE,SESSION_SET_PASSWORD,SESSION_OPEN_DOOR,\
+	SESSION_CHANGE_PASSWORD,SESSION_NEW_PASSWORD,SESSION_LOCKOUT,SESSION_DOOR,\
+	SESSION_AUDIT,SESSION_TRACE};
+/*Structure to track the session of each HMI panel*/
+typedef struct{
+	uint8 address;
+	uint8 door;     /*index of the door opened by the panel*/
+	uint8 state;
+	bool present;   /*the panel answered at the baud rate of the bus*/
+	uint8 attempts; /*wrong passwords of the running command*/
+	bool streaming; /*the password is received digit by digit*/
+	uint8 index;    /*digits of the streamed password matched so far*/
+	uint8 check;    /*result of the streamed password so far*/
+}Panel_Session;
+/* Global Variable to store the sessions of all HMI panels*/
+Panel_Session g_sessions[PANELS_NUMBER]={
+		{INSIDE_PANEL_ADDRESS,0,SESSION_IDLE}
+#if (PANELS_NUMBER > 1)
+		,{OUTSIDE_PANEL_ADDRESS,1%DOORS_NUMBER,SESSION_IDLE}
+#endif
+#if (PANELS_NUMBER > 2)
+		,{THIRD_PANEL_ADDRESS,2%DOORS_NUMBER,SESSION_IDLE}
+#endif
+};
+/* Global Variable to point to the session served now, the other panels
+ * are answered with BUSY until it ends. A session leaves it once its door
+ * starts moving so the other doors can be opened meanwhile*/
+Panel_Session *g_activeSession=NULL_PTR;
+/*Structure to track a door; its motor, its state machine and the timer of
+ *its current state*/
+typedef struct{
+	Dcmotor_Type motor;
+	Swtimer_Type timer;
+	uint8 state;
+	uint32 startUs;         /*start of the opening, to measure it*/
+	Panel_Session *session; /*panel which opened the door, NULL_PTR if closed*/
+	volatile uint8 events;  /*DOOR_EVENT_TIMER and end stops not handled yet*/
+	volatile bool eventPending; /*EVENT_DOOR is waiting in the queue*/
+}Door_Type;
+/* Global Variable to store the doors*/
+Door_Type g_doors[DOORS_NUMBER];
+/* Motors of the doors, door 0 keeps the pins of the single door version*/
+const Dcmotor_ConfigType g_motorConfigs[ENDSTOP_DOORS]={
+#if (DOORS_NUMBER > 2)
+		{0,CW,DCMOTOR_OC2,&PORTB,&DDRB,PB0,PB1},
+#else
+		{0,CW,DCMOTOR_OC2,&PORTD,&DDRD,PD5,PD6},
+#endif
+		{0,CW,DCMOTOR_OC1B,&PORTA,&DDRA,PA0,PA1},
+		{0,CW,DCMOTOR_OC1A,&PORTA,&DDRA,PA4,PA5}};
+/* Global Variables to track the audit log sent to the active session, the
+ * next page and if it is read*/
+uint8 g_auditPage;
+bool g_auditReading;
+/* Global Variable to store the trace records left to send to the active
+ * session*/
+uint8 g_traceCount;
+/* Global Variable to end the active session of a panel which stopped
+ * sending*/
+Swtimer_Type g_sessionTimer;
+/* Global Variable to send FRAME_READY to the absent panels*/
+Swtimer_Type g_probeTimer;
+/* Global Variable to store the baud rate of the bus*/
+uint32 g_baudRate=UART_DEFAULT_BAUD;
+/* Global Variable to store if the password is set or not*/
+bool g_passwordIsSet=FALSE;
 /*Function to check if 2 passwords are matched or not*/
 uint8 matchingCheck(uint8 * password , uint8 * password_2);
-/*Function to receive password from HMI ECU using UART protocol*/
-void receivePassword(uint8 *password);
-/*Function to write password to EEPROM*/
+/*Function to wait for a frame of certain type from HMI ECU at boot*/
+bool receiveFrame(Frame_Type *frame,uint8 type,uint16 timeout);
+/*Function to wait for the present panels to acknowledge the baud rate*/
+bool receiveBaudAcks(Frame_Type *frame);
+/*Function to handle a frame received from HMI ECU*/
+void handleFrame(const Frame_Type *frame);
+/*Function to handle the expiry of a software timer*/
+void handleTimer(uint8 timer);
+/*Function to latch an event of a door and post its EVENT_DOOR*/
+void doorLatch(Door_Type *door,uint8 event);
+/*Function to handle the latched events of a door*/
+void handleDoorEvents(Door_Type *door);
+/*Function to start checking the password carried by a command frame*/
+void startCheck(Panel_Session *session,const Frame_Type *command);
+/*Function to check one digit of a streamed password*/
+void checkDigit(Panel_Session *session,uint8 digit);
+/*Function to answer a checked password*/
+void finishCheck(Panel_Session *session,uint8 check);
+/*Function to copy a password terminated by 13 from a frame payload*/
+uint8 extractPassword(const uint8 *payload,uint8 length,uint8 *password);
+/*Function to send a state to HMI ECU in a status frame*/
+void sendStatus(uint8 status);
+/*Function to find the session of the HMI panel which has certain address*/
+Panel_Session *findSession(uint8 address);
+/*Function to ask an HMI ECU to send a corrupted frame again*/
+void nackFrame(uint8 address);
+/*Function to end the active session*/
+void endSession(void);
+/*Function to add a panel which offers its baud rates to the bus*/
+void adoptPanel(Panel_Session *session,const Frame_Type *offer);
+/*Function to write password to EEPROM through the credential cache*/
 void writePasswordToEeprom(uint8 *password);
-/*Function to read password from EEPROM*/
-void readPasswordFromEeprom(uint8 *password);
+/*Function to read the saved password from the credential cache*/
+void readSavedPassword(uint8 *password);
 /*Function to activate the buzzer*/
 void BUZZER_on(void);
-/*Call back function for timer 1*/
-void periodCallBack(void);
-/*Function to make the process of opening the door*/
-void openDoor(uint8 *password,uint8 *password_2);
-/*Function to make the process of changing the password*/
-void changePassword(uint8 *password,uint8 *password_2);
-/*Function to set the password and save it to EEPROM*/
-void setPassword(uint8 *password,uint8 *password_2);
+/*Function to deactivate the buzzer once the lockout ends*/
+void BUZZER_off(void);
+/*Call back function of the TWI software timer*/
+void twiCallBack(Swtimer_Type *timer);
+/*Call back function of the power software timer*/
+void powerCallBack(Swtimer_Type *timer);
+/*Call back function of the frame software timer*/
+void frameCallBack(Swtimer_Type *timer);
+/*Call back functions posting the events of the ISRs*/
+void uartRxCallBack(void);
+void frameTxCallBack(void);
+void timerCallBack(Swtimer_Type *timer);
+void auditCallBack(void);
+void twiRecoveryCallBack(void);
+void endStopCallBack(uint8 door,Endstop_Type stop);
+void endStopScanCallBack(Swtimer_Type *timer);
+/*Function to log an event of the active session in the audit log*/
+void auditEvent(uint8 type);
+/*Function to start sending the audit log to HMI ECU*/
+void sendAuditLog(void);
+/*Function to send the next page of the audit log*/
+void sendAuditPage(void);
+/*Function to send the events of one audit page*/
+void sendAuditRecords(const Audit_RecordType *records,uint8 n);
+/*Function to send the time spent awake and asleep to HMI ECU*/
+void sendPowerStats(void);
+/*Function to start sending the trace records to HMI ECU*/
+void sendTrace(void);
+/*Function to send the next trace records*/
+void sendTraceFrames(void);
+/*Function to start the process of opening the door of the active session*/
+void openDoor(void);
+/*Function to move a door state machine to a state*/
+void doorEnter(Door_Type *door,uint8 state);
+/*Function to handle the expiry of a door timer*/
+void doorStep(Door_Type *door);
+/*Function to handle a command sent during a door sequence*/
+void doorCommand(Door_Type *door,uint8 command);
+/*Function to send a door state to the panel which opened the door*/
+void sendDoorStatus(Door_Type *door,const uint8 *status,uint8 length);
+/*Function to stop a door at an end stop*/
+void handleEndStop(Door_Type *door,uint8 stop);
+/*Function to check a new password and its confirmation and save it*/
+void setPassword(Panel_Session *session,const Frame_Type *frame);
 
 int main(void){
-	volatile uint8 password[15];
-	volatile uint8 password_2[15];
-	uint8 i;
-	uint8 state;
-	Timer1_ConfigType period;
-	Dcmotor_ConfigType motor;
+	Frame_Type frame;
+	Sched_EventType event;
+	Frame_Status status;
+	uint8 i,present=0;
+	uint8 timers;
+	uint32 baudRate;
 	Uart_ConfigType uart;
 	/*Setting the UART Configurations*/
-	uart.baudRate=9600;
-	uart.dataBits=UART_8_BIT;
+	uart.baudRate=UART_DEFAULT_BAUD;
+	uart.dataBits=UART_9_BIT;
 	uart.stopBits=UART_1_BIT;
 	uart.parityType=UART_DISABLE_PARITY;
+	uart.busMode=UART_BUS_MASTER;
+	uart.address=0;
 	/*Initializing UART*/
 	UART_init(&uart);
+	FRAME_init();
 	/*Enable I-Bit*/
 	SET_BIT(SREG,7);
-	/*Setting the Timer 1 Configurations to count 1 second every Interrupt*/
-	period.mode=TIMER1_CTC;
-	period.clock=TIMER1_F_CPU_64;
-	period.initialValue=0;
-	period.oc1AMode=OC1_A_DISCONNECT;
-	period.oc1BMode=OC1_B_DISCONNECT;
-	period.tick=15625;
-	TIMER1_init(&period);
-	TIMER1_setCallBack(periodCallBack,TIMER1_CTC);
-	TIMER1_stopCount();
-	/*Initializing EEPROM*/
+	/*Starting the software timers on Timer 1, it keeps running as the time
+	 * base of the system*/
+	SWTIMER_init();
+	SWTIMER_start(&g_twiTimer,TWI_TICK_MS/SWTIMER_TICK_MS,\
+			TWI_TICK_MS/SWTIMER_TICK_MS,twiCallBack);
+	SWTIMER_start(&g_powerTimer,1,1,powerCallBack);
+	SWTIMER_start(&g_frameTimer,1,1,frameCallBack);
+	/*The time asleep is measured with the software timers clock*/
+	POWER_setClock(SWTIMER_nowUs,SWTIMER_TICK_MS*1000UL);
+	/*Initializing EEPROM, loading the saved password once and finding the
+	 * end of the audit log*/
+	TWI_setRecoveryCallBack(twiRecoveryCallBack);
 	EEPROM_init();
-	/*Setting DC Motor Configurations*/
-	motor.speedPercentage=0;
-	motor.rotationDirection=CW;
-	/*Initializing DC Motor*/
-	DCMOTOR_init(&motor);
-	/*Tell HMI ECU the I am ready to receive the data*/
-	UART_sendByte(CONTROL_ECU_READY);
-	setPassword(password,password_2);
+	CREDENTIAL_init();
+	g_passwordIsSet=CREDENTIAL_isValid();
+	AUDIT_init();
+	AUDIT_setCallBack(auditCallBack);
+	/*Initializing the DC Motors, the doors are closed so keep the motors
+	 * and their PWM stopped*/
+	for(i=0;i<DOORS_NUMBER;i++){
+		DCMOTOR_init(&g_doors[i].motor,&g_motorConfigs[i]);
+		DCMOTOR_stop(&g_doors[i].motor);
+		g_doors[i].state=DOOR_CLOSED;
+		g_doors[i].session=NULL_PTR;
+	}
+	ENDSTOP_init();
+	ENDSTOP_setCallBack(endStopCallBack);
+#if (DOORS_NUMBER > 1)
+	SWTIMER_start(&g_endStopTimer,1,1,endStopScanCallBack);
+#endif
+	/*Tell each HMI ECU the I am ready to receive the data and switch to
+	 * the fastest baud rate supported by all the panels which answered*/
+	baudRate=UART_getSupportedBaudRate(0);
+	for(i=0;i<PANELS_NUMBER;i++){
+		g_activeSession=&g_sessions[i];
+		FRAME_send(g_activeSession->address,FRAME_READY,NULL_PTR,0);
+		g_activeSession->present=receiveFrame(&frame,FRAME_BAUD_OFFER,\
+				SWTIMER_MS(PANEL_OFFER_TIMEOUT_MS));
+		if(g_activeSession->present){
+			baudRate=FRAME_commonBaudRate(&frame,baudRate);
+			present++;
+		}
+	}
+	g_activeSession=NULL_PTR;
+	/*If the select frame is not queued all ECUs keep UART_DEFAULT_BAUD. The
+	 * panels acknowledge the new baud rate at it and are sent it again to
+	 * confirm, if one of them does not all ECUs go back to
+	 * UART_DEFAULT_BAUD and the panels are adopted at it*/
+	if((present!=0) && FRAME_selectBaudRate(UART_BROADCAST_ADDRESS,baudRate)){
+		if(receiveBaudAcks(&frame)){
+			g_baudRate=baudRate;
+			FRAME_sendBaudRate(UART_BROADCAST_ADDRESS,baudRate);
+		}
+		else{
+			UART_setBaudRate(UART_DEFAULT_BAUD);
+			FRAME_flush();
+			for(i=0;i<PANELS_NUMBER;i++){
+				g_sessions[i].present=FALSE;
+			}
+		}
+	}
+	/*The absent panels are adopted once they answer*/
+	SWTIMER_start(&g_probeTimer,SWTIMER_MS(PANEL_PROBE_MS),\
+			SWTIMER_MS(PANEL_PROBE_MS),timerCallBack);
+	/*From now on the ISRs post events and the loop handles each of them to
+	 * completion, no handler waits for the HMI ECU or for a timer. The
+	 * bytes received before the callback is set are handled first*/
+	UART_setRxCallBack(uartRxCallBack);
+	FRAME_setTxCallBack(frameTxCallBack);
+	SCHED_post(EVENT_UART_RX,0);
 	while(1){
-		/*Waiting to receive the state from HMI ECU; Open the door or Change
-		 * the password*/
-		state=UART_receiveByte();
-		switch(state){
-		case OPEN:
-			openDoor(password,password_2);
+		/*The queue is checked with the I-bit cleared so an event posted
+		 *before the sleep instruction wakes the MC up. IDLE sleep is used as
+		 *Timer 1, the UART and the TWI must keep running*/
+		CLEAR_BIT(SREG,7);
+		if(!SCHED_get(&event)){
+			TRACE_BEGIN(TRACE_SLEEP,0);
+			POWER_sleep(POWER_IDLE);
+			TRACE_END(TRACE_SLEEP,0);
+			continue;
+		}
+		SET_BIT(SREG,7);
+		TRACE_BEGIN(TRACE_EVENT,event.type);
+		switch(event.type){
+		case EVENT_UART_RX:
+			/*Clear the flag first so a byte received while the buffer is
+			 *drained posts a new event*/
+			g_rxEventPending=FALSE;
+			do{
+				status=FRAME_receive(&frame);
+				if(status==FRAME_COMPLETE){
+					handleFrame(&frame);
+				}
+				else if(status==FRAME_CORRUPTED){
+					nackFrame(frame.address);
+				}
+			}while(status!=FRAME_INCOMPLETE);
+			break;
+		case EVENT_TIMER:
+			/*Clear the flag first so a timer which expires while the latched
+			 *ones are handled posts a new event*/
+			CLEAR_BIT(SREG,7);
+			g_timerEventPending=FALSE;
+			timers=g_timerEvents;
+			g_timerEvents=0;
+			SET_BIT(SREG,7);
+			for(i=0;i<8;i++){
+				if(timers & (1<<i)){
+					handleTimer(i);
+				}
+			}
+			break;
+		case EVENT_EEPROM_DONE:
+			/*Keep the written audit page and write the next staged one once
+			 *the EEPROM is free, then send the next page of the audit log*/
+			g_eepromEventPending=FALSE;
+			AUDIT_process();
+			sendAuditPage();
+			break;
+		case EVENT_DOOR:
+			handleDoorEvents(&g_doors[event.arg]);
 			break;
-		case CHANGE:
-			changePassword(password,password_2);
+		case EVENT_TWI_RECOVER:
+			/*A TWI request timed out, recover the bus out of the ISR*/
+			g_twiEventPending=FALSE;
+			TWI_process();
+			break;
+		case EVENT_FRAME_SENT:
+			/*Send the next frame of the log which is sent*/
+			g_txEventPending=FALSE;
+			sendAuditPage();
+			sendTraceFrames();
 			break;
 		}
+		TRACE_END(TRACE_EVENT,event.type);
 	}
 	return 0;
 }
 
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : handleFrame
+[DESCRIPTION]   : Function is responsible for handling a frame received from
+				  an HMI ECU according to the state of its session. An idle
+				  panel can start a command; Set the password, Open its door,
+				  Change the password or read the audit log. The panel of a
+				  door session can send door commands at any time. Commands
+				  from the other panels are answered with BUSY while a session
+				  is served or while the door of the panel is moving, a NACK is
+				  answered by sending the last frame again and the other
+				  frames are dropped. A panel which offers its baud rates is
+				  added to the bus.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the received frame.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void handleFrame(const Frame_Type *frame){
+	uint8 busy=BUSY;
+	uint8 i;
+	Panel_Session *session=findSession(frame->address);
+	/*Frames from unknown panels are dropped*/
+	if(session==NULL_PTR){
+		return;
+	}
+	if(frame->type==FRAME_BAUD_OFFER){
+		/*An absent panel answered FRAME_READY*/
+		adoptPanel(session,frame);
+		return;
+	}
+	if(frame->type==FRAME_BAUD_SELECT){
+		/*An adopted panel acknowledged the baud rate, confirm it*/
+		FRAME_sendBaudRate(session->address,g_baudRate);
+		return;
+	}
+	/*A valid frame shows the panel runs at the baud rate of the bus*/
+	session->present=TRUE;
+	if(frame->type==FRAME_NACK){
+		/*HMI ECU received a corrupted frame, send the last one again*/
+		FRAME_resend(frame->address);
+		return;
+	}
+	if(session->state==SESSION_DOOR){
+		/*The door sequences do not hold the active session*/
+		if((frame->type==FRAME_DOOR) && (frame->length==1)){
+			doorCommand(&g_doors[session->door],frame->payload[0]);
+		}
+		return;
+	}
+	if((g_activeSession!=NULL_PTR) && (session!=g_activeSession)){
+		/*Only a new command is answered, the digits which follow it are
+		 *dropped*/
+		if(frame->type!=FRAME_DIGIT){
+			FRAME_send(frame->address,FRAME_STATUS,&busy,1);
+		}
+		return;
+	}
+	switch(session->state){
+	case SESSION_IDLE:
+		g_activeSession=session;
+		switch(frame->type){
+		case FRAME_SET_PASSWORD:
+			/*The first panel sets the password, then it can only be
+			 * changed after entering the old one*/
+			if(g_passwordIsSet){
+				sendStatus(BUSY);
+				endSession();
+			}
+			else{
+				session->state=SESSION_SET_PASSWORD;
+				setPassword(session,frame);
+			}
+			break;
+		case FRAME_OPEN_DOOR:
+			/*A door is opened by one panel at a time*/
+			if(g_doors[session->door].session!=NULL_PTR){
+				sendStatus(BUSY);
+				endSession();
+				break;
+			}
+			session->state=SESSION_OPEN_DOOR;
+			session->attempts=0;
+			startCheck(session,frame);
+			break;
+		case FRAME_CHANGE_PASSWORD:
+			session->state=SESSION_CHANGE_PASSWORD;
+			session->attempts=0;
+			startCheck(session,frame);
+			break;
+		case FRAME_AUDIT:
+			/*The session ends once the last page is sent*/
+			sendAuditLog();
+			break;
+		case FRAME_POWER:
+			sendPowerStats();
+			endSession();
+			break;
+		case FRAME_TRACE:
+			/*The session ends once the last records are sent*/
+			sendTrace();
+			break;
+		default:
+			endSession();
+			break;
+		}
+		break;
+	case SESSION_SET_PASSWORD:
+	case SESSION_NEW_PASSWORD:
+		if(frame->type==FRAME_SET_PASSWORD){
+			setPassword(session,frame);
+		}
+		break;
+	case SESSION_OPEN_DOOR:
+	case SESSION_CHANGE_PASSWORD:
+		/*The password is streamed digit by digit or carried by the command
+		 *frame of the next attempt*/
+		if((frame->type==FRAME_DIGIT) && session->streaming){
+			for(i=0;i<frame->length;i++){
+				checkDigit(session,frame->payload[i]);
+			}
+		}
+		else if((!session->streaming) &&\
+				(((session->state==SESSION_OPEN_DOOR) &&\
+				(frame->type==FRAME_OPEN_DOOR)) ||\
+				((session->state==SESSION_CHANGE_PASSWORD) &&\
+				(frame->type==FRAME_CHANGE_PASSWORD)))){
+			startCheck(session,frame);
+		}
+		break;
+	default:
+		/*The lockout ends on its timer and the logs once they are sent*/
+		break;
+	}
+	/*The session ends if its panel stops sending*/
+	if(g_activeSession==session){
+		SWTIMER_start(&g_sessionTimer,SWTIMER_SECONDS(SESSION_TIMEOUT_S),0,\
+				timerCallBack);
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : handleTimer
+[DESCRIPTION]   : Function is responsible for handling the expiry of the
+				  software timers of the door sequences, the buzzer, the
+				  sessions and the absent panels. A session which waits for
+				  a frame of its panel for SESSION_TIMEOUT_S is ended and
+				  the panel is absent until it sends a frame again, the
+				  absent panels are sent FRAME_READY.
+
+[Args]		    :
+				in  -> uint8:
+						This argument is the timer (TIMER_LOCKOUT,
+						TIMER_SESSION, TIMER_PROBE).
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void handleTimer(uint8 timer){
+	uint8 i;
+	if(timer==TIMER_LOCKOUT){
+		BUZZER_off();
+	}
+	else if(timer==TIMER_SESSION){
+		/*The lockout and the logs end on their own*/
+		if((g_activeSession!=NULL_PTR) &&\
+				(g_activeSession->state!=SESSION_LOCKOUT) &&\
+				(g_activeSession->state!=SESSION_AUDIT) &&\
+				(g_activeSession->state!=SESSION_TRACE)){
+			g_activeSession->present=FALSE;
+			endSession();
+		}
+	}
+	else if(timer==TIMER_PROBE){
+		for(i=0;i<PANELS_NUMBER;i++){
+			if(!g_sessions[i].present){
+				FRAME_send(g_sessions[i].address,FRAME_READY,NULL_PTR,0);
+			}
+		}
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : doorLatch
+[DESCRIPTION]   : Function is responsible for latching an event of a door and
+				  posting its EVENT_DOOR if none is waiting, it can be called
+				  from the ISRs. The events latched while EVENT_DOOR waits are
+				  handled with it so none is lost.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the door.
+				in  -> uint8:
+						This argument is the event (DOOR_EVENT_TIMER,
+						1<<ENDSTOP_OPEN, 1<<ENDSTOP_CLOSED).
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void doorLatch(Door_Type *door,uint8 event){
+	uint8 sreg=SREG;
+	CLEAR_BIT(SREG,7);
+	door->events|=event;
+	if(!door->eventPending){
+		door->eventPending=SCHED_post(EVENT_DOOR,(uint8)(door-g_doors));
+	}
+	SREG=sreg;
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : handleDoorEvents
+[DESCRIPTION]   : Function is responsible for handling the events latched by
+				  a door; the end stops first then the expiry of its timer.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the door.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void handleDoorEvents(Door_Type *door){
+	uint8 events;
+	CLEAR_BIT(SREG,7);
+	door->eventPending=FALSE;
+	events=door->events;
+	door->events=0;
+	SET_BIT(SREG,7);
+	if(events & (1<<ENDSTOP_OPEN)){
+		handleEndStop(door,ENDSTOP_OPEN);
+	}
+	if(events & (1<<ENDSTOP_CLOSED)){
+		handleEndStop(door,ENDSTOP_CLOSED);
+	}
+	/*The door timer is armed again if an end stop made the step while
+	 *this event was waiting*/
+	if((events & DOOR_EVENT_TIMER) && !SWTIMER_isArmed(&door->timer)){
+		doorStep(door);
+	}
+}
+
 /* ---------------------------------------------------------------------------
 [FUNCTION NAME] : setPassword
-[DESCRIPTION]   : Function is responsible for receiving two passwords from
-				  the HMI ECU and and check if they are matched or not then send
-				  the check to HMI ECU. Repeating the process until the HMI ECU
-				  send two matched passwords.
+[DESCRIPTION]   : Function is responsible for checking if the two passwords
+				  received from the HMI ECU are matched or not then send the
+				  check to HMI ECU. The session keeps waiting for two new
+				  passwords until the HMI ECU send two matched passwords, then
+				  the password is saved into the EEPROM.
 
 [Args]		    :
-				in  -> point to array:
-						This argument is empty array to store the first password.
-				in  -> point to array:
-						This argument is empty array to store the second password.
+				in  -> point to structure:
+						This argument is the session of the HMI panel.
+				in  -> point to structure:
+						This argument is the frame carrying the password and
+						its confirmation.
 [Return]	   :
 				void
 ------------------------------------------------------------------------------*/
-void setPassword(uint8 *password,uint8 *password_2){
-	receivePassword(password);
-	receivePassword(password_2);
-	g_matchingCheck=matchingCheck(password,password_2);
-	/*While the 2 passwords are not matched repeat receiving 2 password and
-	 * repeat checking*/
-	while(g_matchingCheck==UNMATCHED){
-		UART_sendByte(UNMATCHED);
-		receivePassword(password);
-		receivePassword(password_2);
-		g_matchingCheck=matchingCheck(password,password_2);
+void setPassword(Panel_Session *session,const Frame_Type *frame){
+	uint8 n;
+	n=extractPassword(frame->payload,frame->length,g_password);
+	extractPassword(frame->payload+n,frame->length-n,g_password_2);
+	if(matchingCheck(g_password,g_password_2)==UNMATCHED){
+		sendStatus(UNMATCHED);
+		return;
 	}
 	/*Once they are matched save the password into the EEPROM*/
-	UART_sendByte(MATCHED);
-	writePasswordToEeprom(password);
+	sendStatus(MATCHED);
+	writePasswordToEeprom(g_password);
+	g_passwordIsSet=TRUE;
+	if(session->state==SESSION_NEW_PASSWORD){
+		auditEvent(AUDIT_PASSWORD_CHANGED);
+		sendStatus(DONE);
+	}
+	else{
+		auditEvent(AUDIT_PASSWORD_SET);
+	}
+	endSession();
 }
 
 /* ---------------------------------------------------------------------------
-[FUNCTION NAME] : changePassword
-[DESCRIPTION]   : This function is responsible for receiving password from
-				  HMI ECU and checking if this password and the password saved in
-				  EEPROM are matched or not. If the received password is not
-				  matched for 3 times the buzzer will be activated for 1 min.
-				  If the password is matched then received the new password from
-				  HMI ECU to replace with the saved password in EEPROM
+[FUNCTION NAME] : startCheck
+[DESCRIPTION]   : Function is responsible for checking the password of an
+				  open door or change password command with the saved
+				  password. If the command frame carries the password it is
+				  checked as a whole, otherwise the HMI ECU sends each digit
+				  in a FRAME_DIGIT frame once it is typed and each digit is
+				  compared once it is received.
+
 [Args]		    :
-				in  -> point to array:
-						This argument is empty array to store the received
-						password.
-				in  -> point to array:
-						This argument is empty array to store the saved password
-						in EEPROM.
+				in  -> point to structure:
+						This argument is the session of the HMI panel.
+				in  -> point to structure:
+						This argument is the command frame.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void startCheck(Panel_Session *session,const Frame_Type *command){
+	/*Read the saved password while the user is still typing*/
+	readSavedPassword(g_password_2);
+	if(command->length!=0){
+		session->streaming=FALSE;
+		extractPassword(command->payload,command->length,g_password);
+		finishCheck(session,matchingCheck(g_password,g_password_2));
+	}
+	else{
+		session->streaming=TRUE;
+		session->index=0;
+		session->check=MATCHED;
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : checkDigit
+[DESCRIPTION]   : Function is responsible for comparing one digit of the
+				  streamed password with the saved password, the result is
+				  ready once Enter (13) arrives.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the session of the HMI panel.
+				in  -> uint8:
+						This argument is the received digit.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void checkDigit(Panel_Session *session,uint8 digit){
+	/*The saved password ends with 13 too, so a shorter or a longer
+	 * password is unmatched*/
+	if((session->index==PASSWORD_SIZE) ||\
+			(g_password_2[session->index]!=digit)){
+		session->check=UNMATCHED;
+	}
+	else{
+		session->index++;
+	}
+	if(digit==13){
+		session->streaming=FALSE;
+		finishCheck(session,session->check);
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : finishCheck
+[DESCRIPTION]   : Function is responsible for sending the check of the
+				  password to the HMI ECU. A wrong password is logged in the
+				  audit log and after MAX_ATTEMPTS wrong passwords the buzzer
+				  is activated. A correct password opens the door or waits
+				  for the new password.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the session of the HMI panel.
+				in  -> uint8:
+						This argument is MATCHED OR UNMATCHED.
 [Return]	   :
 				void
 ------------------------------------------------------------------------------*/
-void changePassword(uint8 *password,uint8 *password_2){
-	uint8 n=0;
-	receivePassword(password);
-	readPasswordFromEeprom(password_2);
-	g_matchingCheck=matchingCheck(password,password_2);
-	UART_sendByte(g_matchingCheck);
-	while((g_matchingCheck==UNMATCHED) & (n<2)){
-		n++;
-		receivePassword(password);
-		g_matchingCheck=matchingCheck(password,password_2);
-		UART_sendByte(g_matchingCheck);
+void finishCheck(Panel_Session *session,uint8 check){
+	if(check==UNMATCHED){
+		auditEvent(AUDIT_WRONG_PASSWORD);
+		sendStatus(UNMATCHED);
+		session->attempts++;
+		if(session->attempts==MAX_ATTEMPTS){
+			BUZZER_on();
+		}
 	}
-	if(n==2){
-		BUZZER_on();
+	else if(session->state==SESSION_OPEN_DOOR){
+		sendStatus(MATCHED);
+		openDoor();
 	}
-	else if(g_matchingCheck==MATCHED){
-		setPassword(password,password_2);
-		UART_sendByte(DONE);
+	else{
+		sendStatus(MATCHED);
+		session->state=SESSION_NEW_PASSWORD;
 	}
 }
 
 /* ---------------------------------------------------------------------------
 [FUNCTION NAME] : openDoor
-[DESCRIPTION]   : This function is responsible for receiving the password
-				  from the HMI ECU to check if it's correct or not by comparing
-				  it with the saved password in EEPROM. If the received
-				  password is wrong 3 times the buzzer will be activated for
-				  1 minute. If the password is correct, The DC Motor will rotate
-				  to open the door from 15 seconds and send OPENING to HMI ECU
-				  then stop for 3 seconds and send OPENED to HMI ECU then
-				  revert it direction and rotate for 15 seconds and send CLOSED
-				  to HMI ECU
+[DESCRIPTION]   : This function is responsible for starting the sequence of
+				  the door of the active session once the password is
+				  matched. The door goes through the states of its state
+				  machine; OPENING until the open end stop, OPEN_HOLD for 3
+				  seconds, CLOSING until the closed end stop and CLOSED which
+				  ends the session of the panel. A travel longer than 15
+				  seconds or a STOP command moves it to FAULT with the motor
+				  stopped, which ends the session too. Every transition is
+				  reported to the panel. The active session is left at once
+				  so the other panels are served while the door moves.
 
 [Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void openDoor(void){
+	Door_Type *door=&g_doors[g_activeSession->door];
+	g_activeSession->state=SESSION_DOOR;
+	door->session=g_activeSession;
+	auditEvent(AUDIT_DOOR_OPENED);
+	g_activeSession=NULL_PTR;
+	doorEnter(door,DOOR_OPENING);
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : doorEnter
+[DESCRIPTION]   : This function is responsible for moving a door state
+				  machine to a state; starting the motor and the timer of the
+				  door for the state and reporting it to the panel which
+				  opened the door. OPENED carries the time to open in ms.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the door.
+				in  -> uint8:
+						This argument is the new door state.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void doorEnter(Door_Type *door,uint8 state){
+	uint8 status[3];
+	uint16 openMs;
+	uint8 index=(uint8)(door-g_doors);
+	door->state=state;
+	TRACE_MARK(TRACE_DOOR,(uint8)((index<<4)|state));
+	switch(state){
+	case DOOR_OPENING:
+		/*From CLOSING the motor ramps down and reverses*/
+		DCMOTOR_moveTo(&door->motor,100,DOOR_RAMP_MS);
+		door->startUs=SWTIMER_nowUs();
+		SWTIMER_start(&door->timer,SWTIMER_SECONDS(DOOR_TRAVEL_TIMEOUT_S),0,\
+				timerCallBack);
+		status[0]=OPENING;
+		sendDoorStatus(door,status,1);
+		/*The edge of a switch which is already pressed is never seen*/
+		if(ENDSTOP_isHit(index,ENDSTOP_OPEN)){
+			doorLatch(door,1<<ENDSTOP_OPEN);
+		}
+		break;
+	case DOOR_OPEN_HOLD:
+		/*OPENED carries the time to open in ms, LSB first*/
+		openMs=(uint16)(SWTIMER_elapsedUs(door->startUs)/1000);
+		status[0]=OPENED;
+		status[1]=(uint8)openMs;
+		status[2]=(uint8)(openMs>>8);
+		sendDoorStatus(door,status,3);
+		SWTIMER_start(&door->timer,SWTIMER_SECONDS(DOOR_HOLD_S),0,\
+				timerCallBack);
+		break;
+	case DOOR_CLOSING:
+		DCMOTOR_moveTo(&door->motor,-100,DOOR_RAMP_MS);
+		SWTIMER_start(&door->timer,SWTIMER_SECONDS(DOOR_TRAVEL_TIMEOUT_S),0,\
+				timerCallBack);
+		status[0]=CLOSING;
+		sendDoorStatus(door,status,1);
+		if(ENDSTOP_isHit(index,ENDSTOP_CLOSED)){
+			doorLatch(door,1<<ENDSTOP_CLOSED);
+		}
+		break;
+	case DOOR_CLOSED:
+	case DOOR_FAULT:
+		DCMOTOR_stop(&door->motor);
+		SWTIMER_cancel(&door->timer);
+		status[0]=(state==DOOR_CLOSED) ? CLOSED : FAULT;
+		sendDoorStatus(door,status,1);
+		/*End the session of the panel, it can start a command again*/
+		door->session->state=SESSION_IDLE;
+		door->session=NULL_PTR;
+		break;
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : doorStep
+[DESCRIPTION]   : This function is responsible for the expiry of the timer of
+				  a door. The hold ends by closing the door and a travel
+				  which missed its end stop ends in FAULT.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the door.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void doorStep(Door_Type *door){
+	switch(door->state){
+	case DOOR_OPENING:
+	case DOOR_CLOSING:
+		doorEnter(door,DOOR_FAULT);
+		break;
+	case DOOR_OPEN_HOLD:
+		doorEnter(door,DOOR_CLOSING);
+		break;
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : doorCommand
+[DESCRIPTION]   : This function is responsible for the commands sent by the
+				  panel which opened a door while the door moves or is held
+				  open. OPEN reverses a closing door at once and starts the
+				  hold again, EXTEND_HOLD holds the door open for 10 seconds
+				  from now and STOP stops the motor at once in FAULT. The
+				  other commands are dropped.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the door.
+				in  -> uint8:
+						This argument is the command (COMMAND_OPEN,
+						COMMAND_EXTEND_HOLD, COMMAND_STOP).
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void doorCommand(Door_Type *door,uint8 command){
+	uint8 opened=OPENED;
+	switch(command){
+	case COMMAND_OPEN:
+		if(door->state==DOOR_CLOSING){
+			doorEnter(door,DOOR_OPENING);
+		}
+		else if(door->state==DOOR_OPEN_HOLD){
+			SWTIMER_start(&door->timer,SWTIMER_SECONDS(DOOR_HOLD_S),0,\
+					timerCallBack);
+			sendDoorStatus(door,&opened,1);
+		}
+		break;
+	case COMMAND_EXTEND_HOLD:
+		if(door->state==DOOR_OPEN_HOLD){
+			SWTIMER_start(&door->timer,SWTIMER_SECONDS(DOOR_EXTEND_S),0,\
+					timerCallBack);
+			sendDoorStatus(door,&opened,1);
+		}
+		break;
+	case COMMAND_STOP:
+		if(door->session!=NULL_PTR){
+			doorEnter(door,DOOR_FAULT);
+		}
+		break;
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : sendDoorStatus
+[DESCRIPTION]   : This function is responsible for sending a door state to
+				  the HMI ECU which opened the door in a status frame.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the door.
 				in  -> point to array:
-						This argument is empty array to store the received
-						password.
-				in  -> point to array:
-						This argument is empty array to store the saved password
-						in EEPROM.
-[Return]	   :
-				void
-------------------------------------------------------------------------------*/
-void openDoor(uint8 *password,uint8 *password_2){
-	uint8 n=0;
-	receivePassword(password);
-	readPasswordFromEeprom(password_2);
-	g_matchingCheck=matchingCheck(password,password_2);
-	UART_sendByte(g_matchingCheck);
-	while((g_matchingCheck==UNMATCHED) & (n<2)){
-		n++;
-		receivePassword(password);
-		g_matchingCheck=matchingCheck(password,password_2);
-		UART_sendByte(g_matchingCheck);
-	}
-	if(n==2){
-		BUZZER_on();
-	}
-	else if(g_matchingCheck==MATCHED){
-		DCMOTOR_changeRotationDirection(CW);
-		DCMOTOR_changeSpeed(100);
-		TIMER1_startCount(TIMER1_F_CPU_64);
-		while(g_seconds<15){};
-		TIMER1_stopCount();
-		g_seconds=0;
-		DCMOTOR_stop();
-		UART_sendByte(OPENED);
-		TIMER1_startCount(TIMER1_F_CPU_64);
-		while(g_seconds<3){};
-		TIMER1_stopCount();
-		g_seconds=0;
-		UART_sendByte(CLOSING);
-		DCMOTOR_changeRotationDirection(CCW);
-		DCMOTOR_changeSpeed(100);
-		TIMER1_startCount(TIMER1_F_CPU_64);
-		while(g_seconds<15){};
-		g_seconds=0;
-		TIMER1_stopCount();
-		DCMOTOR_stop();
-		UART_sendByte(CLOSED);
+						This argument is the status payload.
+				in  -> uint8:
+						This argument is the payload length.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void sendDoorStatus(Door_Type *door,const uint8 *status,uint8 length){
+	TRACE_BEGIN(TRACE_FRAME_SEND,status[0]);
+	FRAME_send(door->session->address,FRAME_STATUS,status,length);
+	TRACE_END(TRACE_FRAME_SEND,status[0]);
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : handleEndStop
+[DESCRIPTION]   : This function is responsible for stopping the motor of a
+				  door at once when the door reaches the end stop it is
+				  moving to and moving to the next state without waiting for
+				  the door timer. The other end stop events are dropped.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the door.
+				in  -> uint8:
+						This argument is the end stop (ENDSTOP_OPEN,
+						ENDSTOP_CLOSED).
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void handleEndStop(Door_Type *door,uint8 stop){
+	if((door->state==DOOR_OPENING) && (stop==ENDSTOP_OPEN)){
+		DCMOTOR_stop(&door->motor);
+		doorEnter(door,DOOR_OPEN_HOLD);
+	}
+	else if((door->state==DOOR_CLOSING) && (stop==ENDSTOP_CLOSED)){
+		doorEnter(door,DOOR_CLOSED);
 	}
 }
 
 /* ---------------------------------------------------------------------------
 [FUNCTION NAME] : Buzzer_on
 [DESCRIPTION]   : This function is responsible for activating the buzzer for
-				  1 minute.
+				  1 minute, the lockout timer deactivates it.
 
 [Args]		    :
 				void
@@ -242,55 +1030,448 @@ void openDoor(uint8 *password,uint8 *password_2){
 				void
 ------------------------------------------------------------------------------*/
 void BUZZER_on(void){
+	g_activeSession->state=SESSION_LOCKOUT;
+	auditEvent(AUDIT_LOCKOUT);
 	SET_BIT(DDRD,PD2);
 	SET_BIT(PORTD,PD2);
-	TIMER1_startCount(TIMER1_F_CPU_64);
-	while(g_seconds<60){};
-	g_seconds=0;
-	TIMER1_stopCount();
+	SWTIMER_start(&g_lockoutTimer,SWTIMER_SECONDS(60),0,timerCallBack);
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : Buzzer_off
+[DESCRIPTION]   : This function is responsible for deactivating the buzzer
+				  and sending RESET to HMI ECU once the lockout ends.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void BUZZER_off(void){
 	CLEAR_BIT(PORTD,PD2);
-	UART_sendByte(RESET);
+	sendStatus(RESET);
+	endSession();
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : twiCallBack
+[DESCRIPTION]   : Function is responsible for measuring the TWI timeouts,
+				  it is called every TWI_TICK_MS by a periodic software timer.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the expired software timer.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void twiCallBack(Swtimer_Type *timer){
+	TWI_tick();
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : powerCallBack
+[DESCRIPTION]   : Function is responsible for counting the ticks since boot
+				  for the power statistics, it is called every tick by a
+				  periodic software timer.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the expired software timer.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void powerCallBack(Swtimer_Type *timer){
+	POWER_tick();
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : frameCallBack
+[DESCRIPTION]   : Function is responsible for timing out a frame which stops
+				  in the middle, it posts EVENT_UART_RX at its timeout so
+				  the frame is dropped and its panel is sent a NACK.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the expired software timer.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void frameCallBack(Swtimer_Type *timer){
+	if(FRAME_tick()){
+		uartRxCallBack();
+	}
 }
 
 /* ---------------------------------------------------------------------------
-[FUNCTION NAME] : periodCallBack
-[DESCRIPTION]   : Function is responsible for incrementing the seconds global
-			      variable each timer interrupt.
+[FUNCTION NAME] : uartRxCallBack
+[DESCRIPTION]   : Function is responsible for posting EVENT_UART_RX from the
+				  UART RX interrupt, only one event is waiting at a time as
+				  it handles all the buffered bytes.
 
 [Args]		    :
 				void
 [Return]	   :
 				void
 ------------------------------------------------------------------------------*/
-void periodCallBack(void){
-	g_seconds++;
+void uartRxCallBack(void){
+	if(!g_rxEventPending){
+		g_rxEventPending=SCHED_post(EVENT_UART_RX,0);
+	}
 }
 
 /* ---------------------------------------------------------------------------
-[FUNCTION NAME] : readPasswordFromEeprom
-[DESCRIPTION]   : Function is responsible for reading password from the
-				  external memory EEPROM
+[FUNCTION NAME] : frameTxCallBack
+[DESCRIPTION]   : Function is responsible for posting EVENT_FRAME_SENT from
+				  the UART UDRE interrupt once a frame is sent, so the next
+				  frame of a log can be queued.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void frameTxCallBack(void){
+	if(!g_txEventPending){
+		g_txEventPending=SCHED_post(EVENT_FRAME_SENT,0);
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : timerCallBack
+[DESCRIPTION]   : Function is responsible for latching the expiry of a door,
+				  the lockout, the session or the probe timer from the Timer 1
+				  interrupt and posting one EVENT_TIMER or EVENT_DOOR for the
+				  latched expiries.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the expired software timer.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void timerCallBack(Swtimer_Type *timer){
+	uint8 i;
+	for(i=0;i<DOORS_NUMBER;i++){
+		if(timer==&g_doors[i].timer){
+			doorLatch(&g_doors[i],DOOR_EVENT_TIMER);
+			return;
+		}
+	}
+	if(timer==&g_sessionTimer){
+		g_timerEvents|=(1<<TIMER_SESSION);
+	}
+	else if(timer==&g_probeTimer){
+		g_timerEvents|=(1<<TIMER_PROBE);
+	}
+	else{
+		g_timerEvents|=(1<<TIMER_LOCKOUT);
+	}
+	if(!g_timerEventPending){
+		g_timerEventPending=SCHED_post(EVENT_TIMER,0);
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : endStopCallBack
+[DESCRIPTION]   : Function is responsible for latching an end stop reached by
+				  a door from the external interrupt or the scan of the end
+				  stops and posting the EVENT_DOOR of the door.
+
+[Args]		    :
+				in  -> uint8:
+						This argument is the door index.
+				in  -> Endstop_Type:
+						This argument is the end stop reached by the door.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void endStopCallBack(uint8 door,Endstop_Type stop){
+	if(door<DOORS_NUMBER){
+		doorLatch(&g_doors[door],(uint8)(1<<stop));
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : endStopScanCallBack
+[DESCRIPTION]   : Function is responsible for reading the end stops of the
+				  doors without an external interrupt, it is called every
+				  tick by a periodic software timer.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the expired software timer.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void endStopScanCallBack(Swtimer_Type *timer){
+	ENDSTOP_scan();
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : auditCallBack
+[DESCRIPTION]   : Function is responsible for posting EVENT_EEPROM_DONE from
+				  the TWI interrupt once an audit page is written or read.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void auditCallBack(void){
+	if(!g_eepromEventPending){
+		g_eepromEventPending=SCHED_post(EVENT_EEPROM_DONE,0);
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : twiRecoveryCallBack
+[DESCRIPTION]   : Function is responsible for posting EVENT_TWI_RECOVER from
+				  the Timer 1 interrupt once a TWI request times out, the bus
+				  recovery takes too long for the ISR.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void twiRecoveryCallBack(void){
+	if(!g_twiEventPending){
+		g_twiEventPending=SCHED_post(EVENT_TWI_RECOVER,0);
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : auditEvent
+[DESCRIPTION]   : Function is responsible for staging an event of the active
+				  session with the seconds since boot in the audit log.
+
+[Args]		    :
+				in  -> uint8:
+						This argument is the event type.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void auditEvent(uint8 type){
+	AUDIT_log(type,g_activeSession->address,\
+			SWTIMER_getTicks()/SWTIMER_TICKS_PER_SECOND);
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : sendAuditLog
+[DESCRIPTION]   : Function is responsible for starting to send the audit log
+				  to the HMI ECU of the active session, oldest events first.
+				  The session waits in SESSION_AUDIT while sendAuditPage
+				  sends one EEPROM page per event.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void sendAuditLog(void){
+	g_activeSession->state=SESSION_AUDIT;
+	g_auditPage=0;
+	g_auditReading=FALSE;
+	AUDIT_startRead();
+	sendAuditPage();
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : sendAuditPage
+[DESCRIPTION]   : Function is responsible for sending the next page of the
+				  audit log, it is called on EVENT_EEPROM_DONE and
+				  EVENT_FRAME_SENT. The page read in the background is sent
+				  once the previous frame left the queue and the read of the
+				  next page is started, a read refused by a busy EEPROM is
+				  started on the next event. Every FRAME_AUDIT frame carries
+				  the events of one page as | TYPE | PANEL | TIME (4 bytes,
+				  LSB first) |, the staged events follow the EEPROM pages and
+				  a FRAME_AUDIT frame carrying the dropped events | DROPPED
+				  (2 bytes, LSB first) | ends the log and the session.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void sendAuditPage(void){
+	Audit_RecordType records[AUDIT_RECORDS_PER_PAGE];
+	uint8 payload[2];
+	uint16 dropped;
+	if((g_activeSession==NULL_PTR)||(g_activeSession->state!=SESSION_AUDIT)){
+		return;
+	}
+	/*One frame of the log is queued at a time so the status frames to the
+	 *other panels always find room*/
+	while(!FRAME_isTxBusy()){
+		if(g_auditPage<AUDIT_PAGES){
+			if(!g_auditReading){
+				g_auditReading=(AUDIT_readPage(g_auditPage)==SUCCESS);
+				return;
+			}
+			if(!AUDIT_isReadDone()){
+				return;
+			}
+			g_auditReading=FALSE;
+			g_auditPage++;
+			sendAuditRecords(records,AUDIT_getPage(records));
+		}
+		else if(g_auditPage<AUDIT_PAGES+\
+				(AUDIT_STAGING_SIZE/AUDIT_RECORDS_PER_PAGE)){
+			sendAuditRecords(records,AUDIT_getStaged(g_auditPage-AUDIT_PAGES,\
+					records));
+			g_auditPage++;
+		}
+		else{
+			dropped=AUDIT_getDropped();
+			payload[0]=(uint8)dropped;
+			payload[1]=(uint8)(dropped>>8);
+			FRAME_send(g_activeSession->address,FRAME_AUDIT,payload,2);
+			endSession();
+			return;
+		}
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : sendAuditRecords
+[DESCRIPTION]   : Function is responsible for sending the events of one
+				  audit page to the HMI ECU of the active session in a
+				  FRAME_AUDIT frame, an empty page is not sent.
 
 [Args]		    :
 				in  -> point to array:
-						This argument is an empty array to store the password
-						which will be read from the EEPROM.
+						This argument is the events of the page.
+				in  -> uint8:
+						This argument is the number of events.
 [Return]	   :
 				void
 ------------------------------------------------------------------------------*/
-void readPasswordFromEeprom(uint8 *password){
-	uint8 i=0;
-	EEPROM_readByte((0x0311+i),password[i]);
-	while(password[i]!=13){
-		i++;
-		EEPROM_readByte((0x0311+i),password[i]);
+void sendAuditRecords(const Audit_RecordType *records,uint8 n){
+	uint8 payload[AUDIT_RECORDS_PER_PAGE*6];
+	uint8 j;
+	if(n==0){
+		return;
+	}
+	for(j=0;j<n;j++){
+		payload[6*j]=records[j].type;
+		payload[6*j+1]=records[j].panel;
+		payload[6*j+2]=(uint8)records[j].time;
+		payload[6*j+3]=(uint8)(records[j].time>>8);
+		payload[6*j+4]=(uint8)(records[j].time>>16);
+		payload[6*j+5]=(uint8)(records[j].time>>24);
+	}
+	FRAME_send(g_activeSession->address,FRAME_AUDIT,payload,6*n);
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : sendPowerStats
+[DESCRIPTION]   : Function is responsible for sending the ticks spent awake
+				  and asleep since boot to the HMI ECU of the active session
+				  in a FRAME_POWER frame as | AWAKE | ASLEEP | (4 bytes each,
+				  LSB first).
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void sendPowerStats(void){
+	uint32 awake,asleep;
+	uint8 payload[8];
+	uint8 i;
+	POWER_getStats(&awake,&asleep);
+	for(i=0;i<4;i++){
+		payload[i]=(uint8)(awake>>(8*i));
+		payload[4+i]=(uint8)(asleep>>(8*i));
 	}
+	FRAME_send(g_activeSession->address,FRAME_POWER,payload,8);
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : sendTrace
+[DESCRIPTION]   : Function is responsible for starting to send the trace
+				  records to the HMI ECU of the active session. The session
+				  waits in SESSION_TRACE while sendTraceFrames sends them.
+				  The records added while they are sent are kept for the
+				  next time.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void sendTrace(void){
+	g_activeSession->state=SESSION_TRACE;
+	g_traceCount=TRACE_count();
+	sendTraceFrames();
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : sendTraceFrames
+[DESCRIPTION]   : Function is responsible for sending the next trace records,
+				  oldest first, taking them out of the ring once the previous
+				  frame left the queue. It is called on EVENT_FRAME_SENT.
+				  Every FRAME_TRACE frame carries up to 3 records as | TICKS
+				  (4 bytes) | PERIODS | TCNT1 (2 bytes) | ID | ARG |, LSB
+				  first, and an empty FRAME_TRACE frame ends the trace and
+				  the session.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void sendTraceFrames(void){
+	Trace_RecordType record;
+	uint8 payload[(FRAME_MAX_PAYLOAD/TRACE_RECORD_SIZE)*TRACE_RECORD_SIZE];
+	uint8 j,n=0;
+	if((g_activeSession==NULL_PTR)||(g_activeSession->state!=SESSION_TRACE)||\
+			FRAME_isTxBusy()){
+		return;
+	}
+	while((g_traceCount!=0) && (n<sizeof(payload))){
+		if(!TRACE_pop(&record)){
+			g_traceCount=0;
+			break;
+		}
+		g_traceCount--;
+		for(j=0;j<4;j++){
+			payload[n++]=(uint8)(record.time.ticks>>(8*j));
+		}
+		payload[n++]=record.time.periods;
+		payload[n++]=(uint8)record.time.counts;
+		payload[n++]=(uint8)(record.time.counts>>8);
+		payload[n++]=record.id;
+		payload[n++]=record.arg;
+	}
+	FRAME_send(g_activeSession->address,FRAME_TRACE,payload,n);
+	if(n==0){
+		endSession();
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : readSavedPassword
+[DESCRIPTION]   : Function is responsible for reading the saved password
+				  from the RAM cache of the EEPROM record loaded at boot
+
+[Args]		    :
+				in  -> point to array:
+						This argument is an empty array to store the saved
+						password.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void readSavedPassword(uint8 *password){
+	CREDENTIAL_read(password);
 }
 
 /* ---------------------------------------------------------------------------
 [FUNCTION NAME] : writePasswordToEeprom
 [DESCRIPTION]   : Function is responsible for writing the password in the
-				  external memory EEPROM
+				  credential cache and through it in the external memory
+				  EEPROM with its CRC using one page write
 
 [Args]		    :
 				in  -> point to array:
@@ -300,36 +1481,262 @@ void readPasswordFromEeprom(uint8 *password){
 				void
 ------------------------------------------------------------------------------*/
 void writePasswordToEeprom(uint8 *password){
-	uint8 i=0;
-	EEPROM_writeByte((0x0311+i),password[i]);
-	while(password[i]!=13){
-		i++;
-		EEPROM_writeByte((0x0311+i),password[i]);
+	CREDENTIAL_write(password);
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : receiveFrame
+[DESCRIPTION]   : Function is responsible for waiting for a frame of certain
+				  type from the HMI ECU of the active session. Corrupted frames
+				  are answered with a NACK and frames of other types are
+				  dropped, a NACK is answered by sending the last frame sent
+				  to the panel again and commands from the other panels are
+				  answered with BUSY. The software timer ticks wake the MC up
+				  to check the timeout.
+
+[Args]		    :
+				out -> point to structure:
+						This argument is a frame to store the received frame.
+				in  -> uint8:
+						This argument is the required frame type.
+				in  -> uint16:
+						This argument is the timeout in software timer ticks.
+[Return]	   :
+				out -> TRUE if the frame is received, FALSE on timeout
+------------------------------------------------------------------------------*/
+bool receiveFrame(Frame_Type *frame,uint8 type,uint16 timeout){
+	uint8 busy=BUSY;
+	Frame_Status status;
+	uint32 start=SWTIMER_getTicks();
+	while(1){
+		status=FRAME_receive(frame);
+		if(status==FRAME_INCOMPLETE){
+			if(SWTIMER_getTicks()-start>=timeout){
+				return FALSE;
+			}
+			/*Sleep until the next byte is received*/
+			CLEAR_BIT(SREG,7);
+			if(UART_available()==0){
+				POWER_sleep(POWER_IDLE);
+			}
+			else{
+				SET_BIT(SREG,7);
+			}
+		}
+		else if(status==FRAME_CORRUPTED){
+			nackFrame(frame->address);
+		}
+		else if(status==FRAME_COMPLETE){
+			if(frame->type==FRAME_NACK){
+				FRAME_resend(frame->address);
+			}
+			else if(frame->address!=g_activeSession->address){
+				/*Only a new command is answered, the digits which follow
+				 * it are dropped*/
+				if((findSession(frame->address)!=NULL_PTR) &&\
+						(frame->type!=FRAME_DIGIT)){
+					FRAME_send(frame->address,FRAME_STATUS,&busy,1);
+				}
+			}
+			else if(frame->type==type){
+				return TRUE;
+			}
+		}
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : receiveBaudAcks
+[DESCRIPTION]   : Function is responsible for waiting at boot for every
+				  present panel to acknowledge the selected baud rate with a
+				  FRAME_BAUD_SELECT frame sent at it. The other frames are
+				  dropped, the panels do not start a command before they are
+				  confirmed.
+
+[Args]		    :
+				out -> point to structure:
+						This argument is a frame to store the received frames.
+[Return]	   :
+				out -> TRUE if all present panels acknowledged it, FALSE
+					   after BAUD_ACK_TIMEOUT_MS
+------------------------------------------------------------------------------*/
+bool receiveBaudAcks(Frame_Type *frame){
+	Frame_Status status;
+	Panel_Session *session;
+	uint8 i,waiting=0;
+	uint32 start=SWTIMER_getTicks();
+	for(i=0;i<PANELS_NUMBER;i++){
+		if(g_sessions[i].present){
+			waiting|=(1<<i);
+		}
+	}
+	while(waiting!=0){
+		status=FRAME_receive(frame);
+		if(status==FRAME_INCOMPLETE){
+			if(SWTIMER_getTicks()-start>=SWTIMER_MS(BAUD_ACK_TIMEOUT_MS)){
+				return FALSE;
+			}
+			CLEAR_BIT(SREG,7);
+			if(UART_available()==0){
+				POWER_sleep(POWER_IDLE);
+			}
+			else{
+				SET_BIT(SREG,7);
+			}
+		}
+		else if((status==FRAME_COMPLETE) &&\
+				(frame->type==FRAME_BAUD_SELECT)){
+			session=findSession(frame->address);
+			if(session!=NULL_PTR){
+				waiting&=~(1<<(uint8)(session-g_sessions));
+			}
+		}
 	}
+	return TRUE;
 }
 
 /* ---------------------------------------------------------------------------
-[FUNCTION NAME] : receivePassword
-[DESCRIPTION]   : Function is responsible for receiving password from HMI ECU
+[FUNCTION NAME] : extractPassword
+[DESCRIPTION]   : Function is responsible for copying a password terminated
+				  by 13 from a frame payload, it stops at the end of the
+				  payload. A password without its terminator is terminated
+				  and a password longer than PASSWORD_SIZE is left without
+				  it so it is never matched.
 
 [Args]		    :
+				in  -> point to array:
+						This argument is the frame payload.
+				in  -> uint8:
+						This argument is the number of payload bytes left.
 				in  -> point to array:
 						This argument is an empty array to store the password.
 [Return]	   :
-				void
+				out -> number of payload bytes used including the terminator
 ------------------------------------------------------------------------------*/
-void receivePassword(uint8 *password){
+uint8 extractPassword(const uint8 *payload,uint8 length,uint8 *password){
 	uint8 i=0;
-	password[i]=UART_receiveByte();
-	while (password[i]!=13){
+	while((i<length) && (i<PASSWORD_SIZE)){
+		password[i]=payload[i];
 		i++;
-		password[i]=UART_receiveByte();
+		if(password[i-1]==13){
+			return i;
+		}
+	}
+	if(i<PASSWORD_SIZE){
+		password[i]=13;
+	}
+	return i;
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : sendStatus
+[DESCRIPTION]   : Function is responsible for sending a state to the HMI ECU
+				  of the active session in a status frame.
+
+[Args]		    :
+				in  -> uint8:
+						This argument is the state (MATCHED, OPENED, ...).
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void sendStatus(uint8 status){
+	/*The frame is queued behind the previous ones, the queue holds far more
+	 *status frames than a session sends before the HMI ECU answers*/
+	TRACE_BEGIN(TRACE_FRAME_SEND,status);
+	FRAME_send(g_activeSession->address,FRAME_STATUS,&status,1);
+	TRACE_END(TRACE_FRAME_SEND,status);
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : findSession
+[DESCRIPTION]   : Function is responsible for finding the session of the HMI
+				  panel which has certain address.
+
+[Args]		    :
+				in  -> uint8:
+						This argument is the HMI panel address.
+[Return]	   :
+				out -> point to the session or NULL_PTR for unknown panel
+------------------------------------------------------------------------------*/
+Panel_Session *findSession(uint8 address){
+	uint8 i;
+	for(i=0;i<PANELS_NUMBER;i++){
+		if(g_sessions[i].address==address){
+			return &g_sessions[i];
+		}
+	}
+	return NULL_PTR;
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : nackFrame
+[DESCRIPTION]   : Function is responsible for sending a NACK to the HMI ECU
+				  which sent a corrupted frame, so it sends its last frame
+				  again. The address of the frame can be corrupted too, so
+				  the unknown addresses are dropped.
+
+[Args]		    :
+				in  -> uint8:
+						This argument is the address of the corrupted frame.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void nackFrame(uint8 address){
+	if(findSession(address)!=NULL_PTR){
+		FRAME_send(address,FRAME_NACK,NULL_PTR,0);
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : endSession
+[DESCRIPTION]   : Function is responsible for ending the active session so
+				  the other panels can start a command.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void endSession(void){
+	SWTIMER_cancel(&g_sessionTimer);
+	g_activeSession->state=SESSION_IDLE;
+	g_activeSession=NULL_PTR;
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : adoptPanel
+[DESCRIPTION]   : Function is responsible for adding a panel which offers
+				  its baud rates to the bus, a panel which was absent at boot
+				  or which booted again. It is sent the baud rate of the bus,
+				  which it already runs at as it received FRAME_READY, and a
+				  command it was running is dropped.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the session of the HMI panel.
+				in  -> point to structure:
+						This argument is the frame offering the baud rates.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void adoptPanel(Panel_Session *session,const Frame_Type *offer){
+	/*All the panels support the same baud rates, a panel which does not
+	 *support the one of the bus stays absent*/
+	if(FRAME_commonBaudRate(offer,g_baudRate)!=g_baudRate){
+		return;
 	}
+	if(session==g_activeSession){
+		endSession();
+	}
+	session->present=TRUE;
+	FRAME_sendBaudRate(session->address,g_baudRate);
 }
 
 /* ---------------------------------------------------------------------------
 [FUNCTION NAME] : matchingCheck
-[DESCRIPTION]   : Function is responsible for comparing two password.
+[DESCRIPTION]   : Function is responsible for comparing two password up to
+				  and including the terminator (13), like the streamed
+				  digits are compared.
 
 [Args]		    :
 				in  -> point to array:
@@ -341,16 +1748,19 @@ void receivePassword(uint8 *password){
 				out -> MATCHED OR UNMATCHED
 ------------------------------------------------------------------------------*/
 uint8 matchingCheck(uint8 * password , uint8 * password_2){
-	uint8 i=0,j=0;
-	while(password[i]!=13){
-		if(password[i]==password_2[i]){
-			j++;
+	uint8 i=0;
+	uint8 check=UNMATCHED;
+	TRACE_BEGIN(TRACE_MATCHING_CHECK,0);
+	/*The terminators are compared too, so a password which is a prefix of
+	 *the other one or which is not terminated is unmatched*/
+	while((i<PASSWORD_SIZE) && (password[i]==password_2[i])){
+		if(password[i]==13){
+			check=MATCHED;
+			break;
 		}
 		i++;
 	}
-	if(j==i)
-		return MATCHED;
-	else
-		return UNMATCHED;
+	TRACE_END(TRACE_MATCHING_CHECK,i);
+	return check;
 }
 
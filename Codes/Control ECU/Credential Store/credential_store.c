@@ -0,0 +1,103 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	credential_store.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Credential Store, a wear-leveled log of password records
+					in the external EEPROM with a write-through RAM cache of
+					the newest one so checking a password does not use the
+					I2C bus
+------------------------------------------------------------------------------*/
+#include "credential_store.h"
+#include "../Frame Protocol/frame.h"
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+/* Copy of the newest EEPROM record: sequence, digits and CRC */
+static uint8 g_record[CREDENTIAL_RECORD_SIZE];
+/* Slot of the newest record, the next record is written after it */
+static uint8 g_slot=CREDENTIAL_SLOTS-1;
+/* A record was found at boot or written */
+static bool g_valid=FALSE;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes(Private)                          *
+ ------------------------------------------------------------------------------*/
+/* Function responsible for calculating the CRC of a record */
+static uint8 CREDENTIAL_crc(const uint8 *record);
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+void CREDENTIAL_init(void){
+	uint8 record[CREDENTIAL_RECORD_SIZE];
+	uint8 slot;
+	uint8 i;
+	g_valid=FALSE;
+	/*Scan all slots once and keep the valid record with the newest sequence,
+	 *torn or erased pages fail the CRC and are skipped*/
+	for(slot=0;slot<CREDENTIAL_SLOTS;slot++){
+		if(EEPROM_readBlock(CREDENTIAL_REGION_ADDRESS+\
+				(uint16)slot*CREDENTIAL_RECORD_SIZE,record,\
+				CREDENTIAL_RECORD_SIZE)!=SUCCESS){
+			continue;
+		}
+		if(record[CREDENTIAL_RECORD_SIZE-1]!=CREDENTIAL_crc(record)){
+			continue;
+		}
+		if((!g_valid)||((sint8)(record[0]-g_record[0])>0)){
+			for(i=0;i<CREDENTIAL_RECORD_SIZE;i++){
+				g_record[i]=record[i];
+			}
+			g_slot=slot;
+			g_valid=TRUE;
+		}
+	}
+}
+
+bool CREDENTIAL_isValid(void){
+	return g_valid;
+}
+
+void CREDENTIAL_read(uint8 *password){
+	uint8 i;
+	for(i=0;i<CREDENTIAL_DIGITS_SIZE;i++){
+		password[i]=g_record[1+i];
+	}
+	password[CREDENTIAL_DIGITS_SIZE]=CREDENTIAL_TERMINATOR;
+}
+
+uint8 CREDENTIAL_write(const uint8 *password){
+	uint8 i=0;
+	/*The sequence of the first record is 0*/
+	g_record[0]=g_valid ? (uint8)(g_record[0]+1) : 0;
+	/*Copy the digits and pad the rest with the terminator*/
+	while((i<CREDENTIAL_DIGITS_SIZE)&&(password[i]!=CREDENTIAL_TERMINATOR)){
+		g_record[1+i]=password[i];
+		i++;
+	}
+	for(;i<CREDENTIAL_DIGITS_SIZE;i++){
+		g_record[1+i]=CREDENTIAL_TERMINATOR;
+	}
+	g_record[CREDENTIAL_RECORD_SIZE-1]=CREDENTIAL_crc(g_record);
+	/*Append to the next slot, the older records stay valid until they are
+	 *overwritten so a failed write leaves the last password in the EEPROM*/
+	g_slot=(g_slot+1)%CREDENTIAL_SLOTS;
+	/*The cache stays the reference even if the EEPROM write fails*/
+	g_valid=TRUE;
+	return EEPROM_writeBlock(CREDENTIAL_REGION_ADDRESS+\
+			(uint16)g_slot*CREDENTIAL_RECORD_SIZE,g_record,\
+			CREDENTIAL_RECORD_SIZE);
+}
+
+static uint8 CREDENTIAL_crc(const uint8 *record){
+	uint8 i;
+	uint8 crc=CREDENTIAL_CRC_INITIAL;
+	for(i=0;i<CREDENTIAL_RECORD_SIZE-1;i++){
+		crc=FRAME_crc8(crc,record[i]);
+	}
+	return crc;
+}
@@ -0,0 +1,62 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	credential_store.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Header File for the Credential Store, a log of password
+					records spread over the external EEPROM with a RAM copy
+					of the newest one
+------------------------------------------------------------------------------*/
+
+#ifndef CREDENTIAL_STORE_H
+#define CREDENTIAL_STORE_H
+
+#include "../Important Heading Files/std_types.h"
+#include "../External EEPROM/external_eeprom.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Preprocessor Macros                                    *
+ ------------------------------------------------------------------------------*/
+/*------------------------- Record Description ---------------------------------
+ * | SEQUENCE | DIGITS (CREDENTIAL_DIGITS_SIZE bytes) | CRC-8 |
+ * SEQUENCE : Incremented by every write, the newest record has the sequence
+ *            which is ahead of all others (modulo 256)
+ * DIGITS   : Password digits, padded with the terminator (13)
+ * CRC-8    : FRAME_crc8 over SEQUENCE and DIGITS starting from
+ *            CREDENTIAL_CRC_INITIAL, so erased (0xFF) and cleared (0x00)
+ *            pages are never valid
+ * Each record fills one EEPROM page, the records are appended round-robin
+ * over CREDENTIAL_SLOTS pages so every write goes to the next page.
+ -----------------------------------------------------------------------------*/
+/* Password array size including the terminator (13) */
+#define CREDENTIAL_PASSWORD_SIZE 15
+#define CREDENTIAL_DIGITS_SIZE (CREDENTIAL_PASSWORD_SIZE-1)
+#define CREDENTIAL_RECORD_SIZE (CREDENTIAL_DIGITS_SIZE+2)
+#define CREDENTIAL_TERMINATOR 13
+#define CREDENTIAL_CRC_INITIAL 0xFF
+/* Region reserved for the records, the first 1 KB of the EEPROM */
+#define CREDENTIAL_REGION_ADDRESS 0x0000
+#define CREDENTIAL_SLOTS 64
+
+#if (CREDENTIAL_RECORD_SIZE != EEPROM_PAGE_SIZE)
+#error "A credential record must fill one EEPROM page"
+#endif
+#if (CREDENTIAL_SLOTS > 127)
+#error "CREDENTIAL_SLOTS must be less than half the sequence range"
+#endif
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes                                   *
+ ------------------------------------------------------------------------------*/
+/* Find the newest valid record, it needs EEPROM_init and the I-bit */
+void CREDENTIAL_init(void);
+/* TRUE if a valid record was found or written */
+bool CREDENTIAL_isValid(void);
+/* Copy the password from the RAM cache, the I2C bus is not used */
+void CREDENTIAL_read(uint8 *password);
+/* Update the RAM cache and append the record to the next EEPROM page */
+uint8 CREDENTIAL_write(const uint8 *password);
+
+#endif
@@ -8,90 +8,372 @@
 [DESCRIPTION]  :	DC Motor Driver
 ------------------------------------------------------------------------------*/
 
+#include <avr/pgmspace.h>
 #include "dc_motor.h"
+#include "../Timer 1/timer1.h"
 #include "../Timer 2/timer2.h"
 
-#ifdef TIMER0
-Timer0_ConfigType timer0Config;
+#define DCMOTOR_PAUSE_TICKS SWTIMER_MS(DCMOTOR_REVERSE_PAUSE_MS)
+#define DCMOTOR_FULL_SCALE 256
+
+#if (DCMOTOR_CURVE_POINTS & (DCMOTOR_CURVE_POINTS-1)) != 0
+#error "DCMOTOR_CURVE_POINTS must be a power of two"
+#endif
+#if (DCMOTOR_START_PERCENT > 100) || (DCMOTOR_GAMMA_MIX > 100)
+#error "DCMOTOR_START_PERCENT and DCMOTOR_GAMMA_MIX are percentages"
 #endif
+/* Curve of a speed, 0 to 1000000 */
+#define DCMOTOR_CURVE(p) ((uint32)(p)*(100-DCMOTOR_GAMMA_MIX)*100UL+\
+		(uint32)(p)*(p)*DCMOTOR_GAMMA_MIX)
+#define DCMOTOR_START_DUTY(top) ((uint32)(top)*DCMOTOR_START_PERCENT/100)
+#define DCMOTOR_DUTY(p,top) (((p)==0) ? 0 : (DCMOTOR_START_DUTY(top)+\
+		(((top)-DCMOTOR_START_DUTY(top))*DCMOTOR_CURVE(p)+500000UL)/1000000UL))
+#define DCMOTOR_DUTY_10(p,top) DCMOTOR_DUTY(p,top),DCMOTOR_DUTY((p)+1,top),\
+		DCMOTOR_DUTY((p)+2,top),DCMOTOR_DUTY((p)+3,top),DCMOTOR_DUTY((p)+4,top),\
+		DCMOTOR_DUTY((p)+5,top),DCMOTOR_DUTY((p)+6,top),DCMOTOR_DUTY((p)+7,top),\
+		DCMOTOR_DUTY((p)+8,top),DCMOTOR_DUTY((p)+9,top)
+#define DCMOTOR_DUTY_TABLE(top) {\
+		DCMOTOR_DUTY_10(0,top),DCMOTOR_DUTY_10(10,top),DCMOTOR_DUTY_10(20,top),\
+		DCMOTOR_DUTY_10(30,top),DCMOTOR_DUTY_10(40,top),DCMOTOR_DUTY_10(50,top),\
+		DCMOTOR_DUTY_10(60,top),DCMOTOR_DUTY_10(70,top),DCMOTOR_DUTY_10(80,top),\
+		DCMOTOR_DUTY_10(90,top),DCMOTOR_DUTY(100,top)}
 
-#ifdef TIMER2
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
 Timer2_ConfigType timer2Config;
+
+#ifdef DCMOTOR_S_CURVE
+/* 3p^2-2p^3 at p=i/DCMOTOR_CURVE_POINTS, scaled by DCMOTOR_FULL_SCALE. The
+ * acceleration starts and ends at 0, so there is no jerk at the ends */
+static const uint16 g_sCurve[DCMOTOR_CURVE_POINTS+1]={
+	0,3,11,24,40,59,81,104,128,152,175,197,216,232,245,253,256
+};
+#define DCMOTOR_PROFILE(i) (g_sCurve[i])
+#else
+#define DCMOTOR_PROFILE(i) ((uint16)(i)*(DCMOTOR_FULL_SCALE/DCMOTOR_CURVE_POINTS))
 #endif
 
+/* Duty of every speed percent for each timer, in the flash as the 1 KB of
+ * RAM cannot spare them. A speed update of a ramp is one table load */
+static const uint8 g_dutyOc2[101] PROGMEM=DCMOTOR_DUTY_TABLE(TOP);
+static const uint16 g_dutyOc1[101] PROGMEM=DCMOTOR_DUTY_TABLE(SWTIMER_PWM_TOP);
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes(Private)                          *
+ ------------------------------------------------------------------------------*/
 static void DCMOTOR_timerSetup(const Dcmotor_ConfigType * Motor_Ptr);
+/* Functions to drive the pins and the PWM without touching the ramp */
+static void DCMOTOR_release(Dcmotor_Type *motor);
+static void DCMOTOR_setDuty(const Dcmotor_Type *motor,uint8 percentage);
+static void DCMOTOR_output(Dcmotor_Type *motor,sint8 speed);
+/* Function responsible for the ticks of a change of the speed, limited by
+ * DCMOTOR_MAX_ACCELERATION */
+static uint16 DCMOTOR_rampTicks(uint8 change,uint16 ramp_ms);
+/* Function responsible for the speeds at the ends of the pieces of a
+ * segment, the multiplications of the ramp are done here once */
+static void DCMOTOR_buildSegment(Dcmotor_Segment *segment,sint8 from,\
+		sint8 to,uint16 ticks);
+static void DCMOTOR_startSegment(Dcmotor_Type *motor,uint8 segment);
+/* Function responsible for starting the next piece of the segment which
+ * lasts a tick at least, FALSE at the end of the segment */
+static bool DCMOTOR_nextPiece(Dcmotor_Type *motor);
+/* Function responsible for the next speed of the ramp, the software timer
+ * callback, every tick */
+static void DCMOTOR_rampTick(Swtimer_Type *timer);
 
 /* ----------------------------------------------------------------------------
  *                      Functions Definitions                                 *
 ------------------------------------------------------------------------------*/
-void DCMOTOR_init(const Dcmotor_ConfigType * Motor_Ptr){
+void DCMOTOR_init(Dcmotor_Type *motor,const Dcmotor_ConfigType * Motor_Ptr){
+	motor -> config = Motor_Ptr;
+	motor -> rampTimer.state = SWTIMER_IDLE;
+	motor -> pauseTicks = 0;
+	motor -> callBack = NULL_PTR;
 	DCMOTOR_timerSetup(Motor_Ptr);
 	/* Configure motor pin as output*/
-	SET_BIT(DCMOTOR_PORT_DIR,IN1);
-	SET_BIT(DCMOTOR_PORT_DIR,IN2);
+	SET_BIT(*(Motor_Ptr -> portDir),Motor_Ptr -> in1);
+	SET_BIT(*(Motor_Ptr -> portDir),Motor_Ptr -> in2);
 	/* Select the direction of rotation*/
-	switch (Motor_Ptr -> rotationDirection){
+	motor -> direction = (Motor_Ptr -> rotationDirection == CW) ? CCW : CW;
+	motor -> speed = 0;
+	DCMOTOR_changeRotationDirection(motor,Motor_Ptr -> rotationDirection);
+	motor -> speed = (motor -> direction == CW) ?\
+			(sint8)Motor_Ptr -> speedPercentage :\
+			-(sint8)Motor_Ptr -> speedPercentage;
+}
+
+void DCMOTOR_revertRotationDirection(Dcmotor_Type *motor){
+	*(motor -> config -> port) ^= ((1<<motor -> config -> in1)|\
+			(1<<motor -> config -> in2));
+	motor -> direction = (motor -> direction == CW) ? CCW : CW;
+	motor -> speed = -motor -> speed;
+}
+
+void DCMOTOR_changeRotationDirection(Dcmotor_Type *motor,\
+		Dcmotor_rotDir direction){
+	const Dcmotor_ConfigType *config = motor -> config;
+	switch (direction){
 	case CW:
-		SET_BIT(DCMOTOR_PORT,IN2);
-		CLEAR_BIT(DCMOTOR_PORT,IN1);
+		SET_BIT(*(config -> port),config -> in2);
+		CLEAR_BIT(*(config -> port),config -> in1);
 		break;
 	case CCW:
-		SET_BIT(DCMOTOR_PORT,IN1);
-		CLEAR_BIT(DCMOTOR_PORT,IN2);
+		SET_BIT(*(config -> port),config -> in1);
+		CLEAR_BIT(*(config -> port),config -> in2);
 	}
+	if(direction != motor -> direction){
+		motor -> direction = direction;
+		motor -> speed = -motor -> speed;
+	}
+}
 
+void DCMOTOR_stop(Dcmotor_Type *motor){
+	SWTIMER_cancel(&motor -> rampTimer);
+	motor -> pauseTicks = 0;
+	DCMOTOR_release(motor);
 }
 
-void DCMOTOR_revertRotationDirection(void){
-	DCMOTOR_PORT ^= ((1<<IN1)|(1<<IN2));
+void DCMOTOR_changeSpeed(Dcmotor_Type *motor,uint8 percentage){
+	if(percentage>100){
+		percentage=100;
+	}
+	SWTIMER_cancel(&motor -> rampTimer);
+	motor -> pauseTicks = 0;
+	DCMOTOR_setDuty(motor,percentage);
+	motor -> speed = (motor -> direction == CW) ? (sint8)percentage :\
+			-(sint8)percentage;
 }
 
-void DCMOTOR_changeRotationDirection(Dcmotor_rotDir direction){
-	switch (direction){
-	case CW:
-		SET_BIT(DCMOTOR_PORT,IN2);
-		CLEAR_BIT(DCMOTOR_PORT,IN1);
+void DCMOTOR_moveTo(Dcmotor_Type *motor,sint8 speed,uint16 ramp_ms){
+	uint8 sreg;
+	uint8 from,to;
+	uint16 ticks,first;
+	sint8 current;
+	if(speed>100){
+		speed=100;
+	}
+	else if(speed<-100){
+		speed=-100;
+	}
+	/*The ramp runs in the Timer 1 ISR*/
+	sreg=SREG;
+	CLEAR_BIT(SREG,7);
+	SWTIMER_cancel(&motor -> rampTimer);
+	motor -> pauseTicks=0;
+	current=motor -> speed;
+	if(current==speed){
+		SREG=sreg;
+		if(motor -> callBack!=NULL_PTR){
+			(*motor -> callBack)(motor);
+		}
+		return;
+	}
+	if(((current>0) && (speed<0)) || ((current<0) && (speed>0))){
+		/*Down to 0 then up in the other direction, the time is split by the
+		 *change of each segment so both have the same slope*/
+		from=(uint8)((current<0) ? -current : current);
+		to=(uint8)((speed<0) ? -speed : speed);
+		ticks=DCMOTOR_rampTicks(from+to,ramp_ms);
+		first=(uint16)(((uint32)ticks*from)/(from+to));
+		if(first==0){
+			first=1;
+		}
+		DCMOTOR_buildSegment(&motor -> segments[0],current,0,first);
+		DCMOTOR_buildSegment(&motor -> segments[1],0,speed,\
+				(ticks>first) ? (ticks-first) : 1);
+		motor -> rampSegments=2;
+	}
+	else{
+		from=(uint8)((current>speed) ? (current-speed) : (speed-current));
+		DCMOTOR_buildSegment(&motor -> segments[0],current,speed,\
+				DCMOTOR_rampTicks(from,ramp_ms));
+		motor -> rampSegments=1;
+	}
+	DCMOTOR_startSegment(motor,0);
+	SWTIMER_start(&motor -> rampTimer,1,1,DCMOTOR_rampTick);
+	SREG=sreg;
+}
+
+void DCMOTOR_setCallBack(Dcmotor_Type *motor,void(*a_ptr)(Dcmotor_Type *motor)){
+	motor -> callBack=a_ptr;
+}
+
+bool DCMOTOR_isMoving(const Dcmotor_Type *motor){
+	return SWTIMER_isArmed(&motor -> rampTimer);
+}
+
+sint8 DCMOTOR_getSpeed(const Dcmotor_Type *motor){
+	return motor -> speed;
+}
+
+static void DCMOTOR_release(Dcmotor_Type *motor){
+	CLEAR_BIT(*(motor -> config -> port),motor -> config -> in1);
+	CLEAR_BIT(*(motor -> config -> port),motor -> config -> in2);
+	switch(motor -> config -> channel){
+	case DCMOTOR_OC2:
+		/* The PWM is not needed while both motor pins are low, stop the
+		 * timer clock to save power */
+		TIMER2_stopCount();
+		break;
+	case DCMOTOR_OC1A:
+		/* Timer 1 keeps counting for the software timers */
+		TIMER1_changeDutyCyle(0,OC1_A);
+		break;
+	case DCMOTOR_OC1B:
+		TIMER1_changeDutyCyle(0,OC1_B);
 		break;
-	case CCW:
-		SET_BIT(DCMOTOR_PORT,IN1);
-		CLEAR_BIT(DCMOTOR_PORT,IN2);
 	}
+	motor -> speed=0;
 }
 
-void DCMOTOR_stop(void){
-	CLEAR_BIT(DCMOTOR_PORT,IN1);
-	CLEAR_BIT(DCMOTOR_PORT,IN2);
+static void DCMOTOR_setDuty(const Dcmotor_Type *motor,uint8 percentage){
+	switch(motor -> config -> channel){
+	case DCMOTOR_OC2:
+		TIMER2_changeDutyCycle(pgm_read_byte(&g_dutyOc2[percentage]));
+		TIMER2_startCount(timer2Config.clock);
+		break;
+	case DCMOTOR_OC1A:
+		TIMER1_changeDutyCyle(pgm_read_word(&g_dutyOc1[percentage]),OC1_A);
+		break;
+	case DCMOTOR_OC1B:
+		TIMER1_changeDutyCyle(pgm_read_word(&g_dutyOc1[percentage]),OC1_B);
+		break;
+	}
 }
 
-void DCMOTOR_changeSpeed(uint8 percentage){
-#ifdef TIMER0
-	TIMER0_changeDutyCycle((uint8)(percentage*TOP/100));
-#endif
+static void DCMOTOR_output(Dcmotor_Type *motor,sint8 speed){
+	if(speed==0){
+		DCMOTOR_release(motor);
+	}
+	else if(speed>0){
+		DCMOTOR_changeRotationDirection(motor,CW);
+		DCMOTOR_setDuty(motor,(uint8)speed);
+	}
+	else{
+		DCMOTOR_changeRotationDirection(motor,CCW);
+		DCMOTOR_setDuty(motor,(uint8)-speed);
+	}
+	motor -> speed=speed;
+}
 
-#ifdef TIMER2
-	TIMER2_changeDutyCycle((uint8)(percentage*TOP/100));
+static uint16 DCMOTOR_rampTicks(uint8 change,uint16 ramp_ms){
+	uint16 ticks=SWTIMER_MS((uint32)ramp_ms);
+#ifdef DCMOTOR_S_CURVE
+	uint16 minimum=(uint16)(((uint32)change*SWTIMER_TICKS_PER_SECOND*3+\
+			2*DCMOTOR_MAX_ACCELERATION-1)/(2*DCMOTOR_MAX_ACCELERATION));
+#else
+	uint16 minimum=(uint16)(((uint32)change*SWTIMER_TICKS_PER_SECOND+\
+			DCMOTOR_MAX_ACCELERATION-1)/DCMOTOR_MAX_ACCELERATION);
 #endif
+	if(ticks<minimum){
+		ticks=minimum;
+	}
+	return (ticks==0) ? 1 : ticks;
 }
 
-static void DCMOTOR_timerSetup(const Dcmotor_ConfigType * Motor_Ptr){
-	/* Setting the configurations of timer 0 to select PWM mode*/
-#ifdef TIMER0
-	timer0Config.initialValue = 0;
-	timer0Config.mode = TIMER0_FAST_PWM;
-	timer0Config.clock = TIMER0_F_CPU_8;
-	timer0Config.dutyCycle = (uint8)(Motor_Ptr -> speedPercentage*TOP/100);
-	timer0Config.oc0Mode = OC0_NON_INVERTNG;
-	TIMER0_init(&timer0Config);
-#endif
+static void DCMOTOR_buildSegment(Dcmotor_Segment *segment,sint8 from,\
+		sint8 to,uint16 ticks){
+	uint8 i;
+	/*A segment does not change the direction, the change is 100 at most*/
+	sint16 change=(sint16)to-from;
+	for(i=0;i<DCMOTOR_CURVE_POINTS;i++){
+		segment -> points[i]=(sint8)(from+(change*(sint16)DCMOTOR_PROFILE(i+1))/\
+				DCMOTOR_FULL_SCALE);
+	}
+	segment -> ticks=ticks;
+}
 
-	/* Setting the configurations of timer 2 to select PWM mode*/
-#ifdef TIMER2
-	timer2Config.initialValue = 0;
-	timer2Config.mode = TIMER2_FAST_PWM;
-	timer2Config.initialValue = 0;
-	timer2Config.clock = TIMER2_F_CPU_8;
-	timer2Config.dutyCycle = (uint8)(Motor_Ptr -> speedPercentage*TOP/100);
-	timer2Config.oc2Mode = OC2_NON_INVERTNG;
-	TIMER2_init(&timer2Config);
-#endif
-};
+static void DCMOTOR_startSegment(Dcmotor_Type *motor,uint8 segment){
+	motor -> rampSegment=segment;
+	motor -> rampPiece=0;
+	motor -> rampStep=0;
+	motor -> rampEnd=0;
+	motor -> rampTotal=0;
+	DCMOTOR_nextPiece(motor);
+}
+
+static bool DCMOTOR_nextPiece(Dcmotor_Type *motor){
+	const Dcmotor_Segment *segment=&motor -> segments[motor -> rampSegment];
+	uint16 start=motor -> rampEnd;
+	sint8 change;
+	/*Piece i ends at tick (i+1)*ticks/DCMOTOR_CURVE_POINTS. The pieces of no
+	 *tick, in a segment shorter than DCMOTOR_CURVE_POINTS ticks, are merged
+	 *with the next one*/
+	do{
+		if(motor -> rampPiece==DCMOTOR_CURVE_POINTS){
+			return FALSE;
+		}
+		motor -> rampTotal+=segment -> ticks;
+		motor -> rampEnd=(uint16)(motor -> rampTotal/DCMOTOR_CURVE_POINTS);
+		motor -> rampPiece++;
+	}while(motor -> rampEnd==start);
+	change=(sint8)(segment -> points[motor -> rampPiece-1]-motor -> speed);
+	motor -> rampSign=(change<0) ? -1 : 1;
+	motor -> rampDelta=(uint8)((change<0) ? -change : change);
+	motor -> rampLength=motor -> rampEnd-start;
+	motor -> rampError=0;
+	return TRUE;
+}
+
+static void DCMOTOR_rampTick(Swtimer_Type *timer){
+	Dcmotor_Type *motor=(Dcmotor_Type *)timer;
+	sint8 speed=motor -> speed;
+	if(motor -> pauseTicks!=0){
+		motor -> pauseTicks--;
+		if(motor -> pauseTicks==0){
+			DCMOTOR_startSegment(motor,1);
+		}
+		return;
+	}
+	/*The speed reaches the end of the piece at its last tick*/
+	motor -> rampError+=motor -> rampDelta;
+	while(motor -> rampError>=motor -> rampLength){
+		motor -> rampError-=motor -> rampLength;
+		speed+=motor -> rampSign;
+	}
+	DCMOTOR_output(motor,speed);
+	motor -> rampStep++;
+	if((motor -> rampStep<motor -> rampEnd) || DCMOTOR_nextPiece(motor)){
+		return;
+	}
+	if(motor -> rampSegment+1<motor -> rampSegments){
+		/*At 0 in the middle of a reversal, let the motor stop first*/
+		motor -> pauseTicks=DCMOTOR_PAUSE_TICKS;
+		if(motor -> pauseTicks==0){
+			DCMOTOR_startSegment(motor,1);
+		}
+	}
+	else{
+		SWTIMER_cancel(timer);
+		if(motor -> callBack!=NULL_PTR){
+			(*motor -> callBack)(motor);
+		}
+	}
+}
+
+static void DCMOTOR_timerSetup(const Dcmotor_ConfigType * Motor_Ptr){
+	uint8 percentage=(Motor_Ptr -> speedPercentage>100) ? 100 :\
+			Motor_Ptr -> speedPercentage;
+	switch(Motor_Ptr -> channel){
+	case DCMOTOR_OC2:
+		/* Setting the configurations of timer 2 to select PWM mode*/
+		timer2Config.initialValue = 0;
+		timer2Config.mode = DCMOTOR_OC2_MODE;
+		timer2Config.clock = DCMOTOR_OC2_CLOCK;
+		timer2Config.dutyCycle = pgm_read_byte(&g_dutyOc2[percentage]);
+		timer2Config.oc2Mode = OC2_NON_INVERTNG;
+		TIMER2_init(&timer2Config);
+		break;
+	case DCMOTOR_OC1A:
+		/* Timer 1 runs in fast PWM mode for the software timers already,
+		 * only the output is connected */
+		TIMER1_changeDutyCyle(pgm_read_word(&g_dutyOc1[percentage]),OC1_A);
+		TIMER1_setOc1AMode(OC1_A_NON_INVERTNG);
+		break;
+	case DCMOTOR_OC1B:
+		TIMER1_changeDutyCyle(pgm_read_word(&g_dutyOc1[percentage]),OC1_B);
+		TIMER1_setOc1BMode(OC1_B_NON_INVERTNG);
+		break;
+	}
+}
@@ -14,39 +14,123 @@
 #include "../Important Heading Files/std_types.h"
 #include "../Important Heading Files/common_macros.h"
 #include "../Important Heading Files/micro_config.h"
+#include "../Software Timer/sw_timer.h"
 
 /* ----------------------------------------------------------------------------
- *                         Timer Stucture Definition                          *
+ *                      Preprocessor Macros                                   *
+  ----------------------------------------------------------------------------*/
+/* Duty of the 8-bit Timer 2 PWM at 100%, the Timer 1 PWM uses SWTIMER_PWM_TOP */
+#define TOP 255
+/* Timer 2 PWM of the OC2 motors (Timer2_ModeOfOperation and Timer2_Clock).
+ * Fast PWM at F_CPU/1 is 31.25 kHz at 8 MHz, above the audible band; phase
+ * correct PWM at F_CPU/1 is 15.7 kHz with the pulses centred in the period.
+ * The OC1A and OC1B motors run at the 1 kHz of the software timers */
+#define DCMOTOR_OC2_MODE TIMER2_FAST_PWM
+#define DCMOTOR_OC2_CLOCK TIMER2_F_CPU_1
+/* Duty of a speed in percent, in tables computed by the compiler: 0 is off,
+ * any other speed starts at DCMOTOR_START_PERCENT below which the motor
+ * stalls, then follows a blend of a linear curve and a square one (gamma 2)
+ * with DCMOTOR_GAMMA_MIX percent of the square one. 0 and 0 give a linear
+ * duty */
+#define DCMOTOR_START_PERCENT 20
+#define DCMOTOR_GAMMA_MIX 50
+/* Ramps of DCMOTOR_moveTo: comment DCMOTOR_S_CURVE for a linear ramp (a
+ * trapezoid speed profile) instead of the S-curve (smoothstep) one */
+#define DCMOTOR_S_CURVE
+/* Steepest change of the speed in percent per second, a ramp shorter than
+ * it allows is lengthened. The S-curve peaks at 1.5 times its mean slope */
+#define DCMOTOR_MAX_ACCELERATION 400
+/* Time with the motor stopped before its direction is reverted */
+#define DCMOTOR_REVERSE_PAUSE_MS 200
+/* Pieces of a ramp segment, the speed is linear along a piece. A power of two
+ * so the ticks of the pieces are found with shifts */
+#define DCMOTOR_CURVE_POINTS 16
+
+/* ----------------------------------------------------------------------------
+ *                         Types Declaration                                  *
  -----------------------------------------------------------------------------*/
 
 typedef enum{
 	CW,CCW
 }Dcmotor_rotDir;
 
+/* PWM output of a motor; OC2 (PD7) of Timer 2, OC1A (PD5) and OC1B (PD4) of
+ * Timer 1 which also times the software timers. A channel drives one motor */
+typedef enum{
+	DCMOTOR_OC2,DCMOTOR_OC1A,DCMOTOR_OC1B
+}Dcmotor_Channel;
+
 typedef struct{
 	uint8 speedPercentage;
 	Dcmotor_rotDir rotationDirection;
+	Dcmotor_Channel channel;
+	/* Direction pins IN1 and IN2 of the motor, on one port */
+	volatile uint8 *port;
+	volatile uint8 *portDir;
+	uint8 in1;
+	uint8 in2;
 }Dcmotor_ConfigType;
 
-/* ----------------------------------------------------------------------------
- *                      Preprocessor Macros                                   *
-  ----------------------------------------------------------------------------*/
-#define TIMER2
-#define TOP 255
-/* DC Motor HW Pins */
-#define DCMOTOR_PORT PORTD
-#define DCMOTOR_PORT_DIR DDRD
-#define IN1 PD5
-#define IN2 PD6
+/*
+ * Segment of a ramp computed by DCMOTOR_moveTo; the speed at the end of each
+ * piece and the ticks of the segment. The ramp tick only walks it
+ */
+typedef struct{
+	sint8 points[DCMOTOR_CURVE_POINTS];
+	uint16 ticks;
+}Dcmotor_Segment;
 
+/*
+ * A motor is owned by the caller and must stay valid while it is used. The
+ * ramp timer is its first member so the timer callback finds the motor.
+ */
+typedef struct Dcmotor
+{
+	Swtimer_Type rampTimer;
+	const Dcmotor_ConfigType *config;
+	volatile sint8 speed;   /* negative for CCW */
+	Dcmotor_rotDir direction;
+	/* The ramp is made of one segment, or of two segments with a pause at
+	 * speed 0 between them when the direction is reverted */
+	Dcmotor_Segment segments[2];
+	uint8 rampSegments;
+	uint8 rampSegment;
+	uint8 rampPiece;
+	uint16 rampStep;       /* ticks of the segment done */
+	uint16 rampEnd;        /* tick of the segment ending the piece */
+	uint32 rampTotal;      /* ticks of the segment times the pieces done */
+	/* The speed steps along a piece like a Bresenham line */
+	uint16 rampLength;
+	uint16 rampError;
+	uint8 rampDelta;
+	sint8 rampSign;
+	uint8 pauseTicks;
+	void (*volatile callBack)(struct Dcmotor *motor);
+}Dcmotor_Type;
 
 /* -----------------------------------------------------------------------------
  *                      Functions Prototypes                                   *
  ------------------------------------------------------------------------------*/
-void DCMOTOR_init(const Dcmotor_ConfigType * Motor_Ptr);
-void DCMOTOR_revertRotationDirection(void);
-void DCMOTOR_changeRotationDirection(Dcmotor_rotDir direction);
-void DCMOTOR_stop(void);
-void DCMOTOR_changeSpeed(uint8 percentage);
+/* The configuration must stay valid while the motor is used. The software
+ * timers must be running before a Timer 1 channel is used */
+void DCMOTOR_init(Dcmotor_Type *motor,const Dcmotor_ConfigType * Motor_Ptr);
+void DCMOTOR_revertRotationDirection(Dcmotor_Type *motor);
+void DCMOTOR_changeRotationDirection(Dcmotor_Type *motor,\
+		Dcmotor_rotDir direction);
+void DCMOTOR_stop(Dcmotor_Type *motor);
+/* Set the speed at once, 100 at most, through the duty table */
+void DCMOTOR_changeSpeed(Dcmotor_Type *motor,uint8 percentage);
+/* Ramp the speed from the current one to speed (percent, negative for CCW)
+ * in ramp_ms at least and return at once. The speed passes by 0 and waits
+ * DCMOTOR_REVERSE_PAUSE_MS to change the direction. A new call starts from
+ * the current speed, DCMOTOR_stop and DCMOTOR_changeSpeed end the ramp.
+ * Needs the software timers running */
+void DCMOTOR_moveTo(Dcmotor_Type *motor,sint8 speed,uint16 ramp_ms);
+/* Function called from the Timer 1 ISR when a DCMOTOR_moveTo speed is
+ * reached, or from DCMOTOR_moveTo if it is the current speed already */
+void DCMOTOR_setCallBack(Dcmotor_Type *motor,void(*a_ptr)(Dcmotor_Type *motor));
+bool DCMOTOR_isMoving(const Dcmotor_Type *motor);
+/* Current speed, negative for CCW */
+sint8 DCMOTOR_getSpeed(const Dcmotor_Type *motor);
 
 #endif
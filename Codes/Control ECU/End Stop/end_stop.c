@@ -0,0 +1,116 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	end_stop.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	End Stop Driver
+------------------------------------------------------------------------------*/
+
+#include "end_stop.h"
+
+/* Bits of the scanned switches in ENDSTOP_SCAN_PIN, indexed by
+ * (door-1)*2+stop */
+#define ENDSTOP_SCAN_SWITCHES ((ENDSTOP_DOORS-1)*2)
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+static void (*volatile g_callBackPtr)(uint8 door,Endstop_Type stop) = NULL_PTR;
+static const uint8 g_scanBits[ENDSTOP_SCAN_SWITCHES]={
+	ENDSTOP_DOOR_1_OPEN_BIT,ENDSTOP_DOOR_1_CLOSED_BIT,\
+	ENDSTOP_DOOR_2_OPEN_BIT,ENDSTOP_DOOR_2_CLOSED_BIT
+};
+/* Mask of the scanned switches pressed at the last scan */
+static uint8 g_scanHits=0;
+
+/* -----------------------------------------------------------------------------
+ *                       Interrupt Service Routines                            *
+ ------------------------------------------------------------------------------*/
+ISR(INT1_vect){
+	ENDSTOP_hit(0,ENDSTOP_OPEN);
+}
+
+ISR(INT2_vect){
+	ENDSTOP_hit(0,ENDSTOP_CLOSED);
+}
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+void ENDSTOP_init(void){
+	uint8 i;
+	/*Inputs with the internal pull-ups*/
+	CLEAR_BIT(ENDSTOP_OPEN_PORT_DIR,ENDSTOP_OPEN_BIT);
+	SET_BIT(ENDSTOP_OPEN_PORT,ENDSTOP_OPEN_BIT);
+	CLEAR_BIT(ENDSTOP_CLOSED_PORT_DIR,ENDSTOP_CLOSED_BIT);
+	SET_BIT(ENDSTOP_CLOSED_PORT,ENDSTOP_CLOSED_BIT);
+	for(i=0;i<ENDSTOP_SCAN_SWITCHES;i++){
+		CLEAR_BIT(ENDSTOP_SCAN_PORT_DIR,g_scanBits[i]);
+		SET_BIT(ENDSTOP_SCAN_PORT,g_scanBits[i]);
+	}
+	/*The switches pressed at boot are not reported, like the edges*/
+	g_scanHits=0;
+	for(i=0;i<ENDSTOP_SCAN_SWITCHES;i++){
+		if(BIT_IS_CLEAR(ENDSTOP_SCAN_PIN,g_scanBits[i])){
+			g_scanHits|=(1<<i);
+		}
+	}
+	/*INT1 on the falling edge*/
+	SET_BIT(MCUCR,ISC11);
+	CLEAR_BIT(MCUCR,ISC10);
+	/*INT2 on the falling edge, changing ISC2 can set INTF2 so it is cleared
+	 *before the interrupt is enabled*/
+	CLEAR_BIT(GICR,INT2);
+	CLEAR_BIT(MCUCSR,ISC2);
+	GIFR = (1<<INTF1)|(1<<INTF2);
+	SET_BIT(GICR,INT1);
+	SET_BIT(GICR,INT2);
+}
+
+void ENDSTOP_setCallBack(void(*a_ptr)(uint8 door,Endstop_Type stop)){
+	g_callBackPtr = a_ptr;
+}
+
+bool ENDSTOP_isHit(uint8 door,Endstop_Type stop){
+	if(door==0){
+		switch(stop){
+		case ENDSTOP_OPEN:
+			return BIT_IS_CLEAR(ENDSTOP_OPEN_PIN,ENDSTOP_OPEN_BIT);
+		case ENDSTOP_CLOSED:
+			return BIT_IS_CLEAR(ENDSTOP_CLOSED_PIN,ENDSTOP_CLOSED_BIT);
+		default:
+			return FALSE;
+		}
+	}
+	if((door>=ENDSTOP_DOORS) || (stop>ENDSTOP_CLOSED)){
+		return FALSE;
+	}
+	return BIT_IS_CLEAR(ENDSTOP_SCAN_PIN,g_scanBits[(door-1)*2+stop]);
+}
+
+void ENDSTOP_scan(void){
+	uint8 i;
+	uint8 hits=0;
+	uint8 pins=ENDSTOP_SCAN_PIN;
+	for(i=0;i<ENDSTOP_SCAN_SWITCHES;i++){
+		if(BIT_IS_CLEAR(pins,g_scanBits[i])){
+			hits|=(1<<i);
+		}
+	}
+	/*Only the switches which were released at the last scan are reported,
+	 *the scan period filters the bounces*/
+	for(i=0;i<ENDSTOP_SCAN_SWITCHES;i++){
+		if((hits & ~g_scanHits) & (1<<i)){
+			ENDSTOP_hit((i>>1)+1,(Endstop_Type)(i & 1));
+		}
+	}
+	g_scanHits=hits;
+}
+
+void ENDSTOP_hit(uint8 door,Endstop_Type stop){
+	if(g_callBackPtr != NULL_PTR){
+		(*g_callBackPtr)(door,stop);
+	}
+}
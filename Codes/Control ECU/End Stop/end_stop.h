@@ -0,0 +1,77 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	end_stop.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Header File for the End Stop Driver, the limit switches of
+					the doors
+------------------------------------------------------------------------------*/
+
+#ifndef END_STOP_H
+#define END_STOP_H
+
+#include "../Important Heading Files/std_types.h"
+#include "../Important Heading Files/common_macros.h"
+#include "../Important Heading Files/micro_config.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Preprocessor Macros                                    *
+ ------------------------------------------------------------------------------*/
+/* Doors of the controller, each one has an open and a closed switch */
+#define ENDSTOP_DOORS 3
+/* End Stop HW Pins, each switch connects its pin to the ground when the door
+ * reaches it. Door 0 is on the external interrupts, INT0 (PD2) drives the
+ * buzzer so INT1 and INT2 are used */
+#define ENDSTOP_OPEN_PORT PORTD
+#define ENDSTOP_OPEN_PORT_DIR DDRD
+#define ENDSTOP_OPEN_PIN PIND
+#define ENDSTOP_OPEN_BIT PD3
+#define ENDSTOP_CLOSED_PORT PORTB
+#define ENDSTOP_CLOSED_PORT_DIR DDRB
+#define ENDSTOP_CLOSED_PIN PINB
+#define ENDSTOP_CLOSED_BIT PB2
+/* The other doors have no external interrupt left, their switches are read
+ * by ENDSTOP_scan; door 1 on PA2 (open) and PA3 (closed), door 2 on PA6 and
+ * PA7. PA0, PA1, PA4 and PA5 are the direction pins of their motors */
+#define ENDSTOP_SCAN_PORT PORTA
+#define ENDSTOP_SCAN_PORT_DIR DDRA
+#define ENDSTOP_SCAN_PIN PINA
+#define ENDSTOP_DOOR_1_OPEN_BIT PA2
+#define ENDSTOP_DOOR_1_CLOSED_BIT PA3
+#define ENDSTOP_DOOR_2_OPEN_BIT PA6
+#define ENDSTOP_DOOR_2_CLOSED_BIT PA7
+#ifndef NULL_PTR
+#define NULL_PTR (void *) 0
+#endif
+
+/* -----------------------------------------------------------------------------
+ *                         Types Declaration                                   *
+ ------------------------------------------------------------------------------*/
+typedef enum
+{
+	ENDSTOP_OPEN,ENDSTOP_CLOSED
+}Endstop_Type;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes                                   *
+ ------------------------------------------------------------------------------*/
+/* Inputs with pull-ups, INT1 and INT2 on the falling edge */
+void ENDSTOP_init(void);
+/* Function called when a door reaches a switch; from the ISR of a switch of
+ * door 0 or from ENDSTOP_scan for the other doors */
+void ENDSTOP_setCallBack(void(*a_ptr)(uint8 door,Endstop_Type stop));
+/* TRUE while the door is at the switch */
+bool ENDSTOP_isHit(uint8 door,Endstop_Type stop);
+/* Read the switches of doors 1 and 2 and report the ones pressed since the
+ * last scan, to be called periodically (every 10 ms) */
+void ENDSTOP_scan(void);
+/*
+ * Called when a door reaches a switch. A simulation or a test stands in for
+ * a switch by calling it. On the target the pin of a switch can be driven
+ * low as an output, INT1 and INT2 are triggered by output pins too.
+ */
+void ENDSTOP_hit(uint8 door,Endstop_Type stop);
+
+#endif
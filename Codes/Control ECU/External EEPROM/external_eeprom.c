@@ -9,86 +9,214 @@
 ------------------------------------------------------------------------------*/
 #include "../I2C/i2c.h"
 #include "external_eeprom.h"
-
+#include "../Trace/trace.h"
 
 /* ----------------------------------------------------------------------------
- *                      Functions Definitions                                 *
+ *                          Global Variables                                  *
 ------------------------------------------------------------------------------*/
 Twi_ConfigType twi;
+/* TWI request of the running operation, one page or one block read */
+static Twi_RequestType g_request;
+/* Word address followed by the data of the page being written */
+static uint8 g_buffer[1+EEPROM_PAGE_SIZE];
+/* Rest of the running block write */
+static volatile uint16 g_address;
+static const uint8 * volatile g_dataPtr;
+static volatile uint16 g_remaining;
+static volatile bool g_busy=FALSE;
+static volatile uint8 g_result;
+static void (* volatile g_callBackPtr)(uint8 result) = NULL_PTR;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes(Private)                          *
+ ------------------------------------------------------------------------------*/
+/* Function responsible for submitting the write of the next page */
+static uint8 EEPROM_writePage(void);
+/* Completion callback of the TWI requests, called from the TWI ISR */
+static void EEPROM_requestDone(Twi_RequestType *request);
+/* Function responsible for ending the running operation */
+static void EEPROM_finish(uint8 result);
 
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
 void EEPROM_init(void)
 {
 	/* just initialize the I2C(TWI) module inside the MC */
 	twi.speed=TWI_400_Kb_S;
 	twi.prescalar=TWI_1;
 	twi.address=0x02;
+	twi.timeout=EEPROM_TIMEOUT_MS;
 	TWI_init(&twi);
 }
 
 uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
 {
-	/* Send the Start Bit */
-    TWI_start();
-    if (TWI_getStatus() != TW_START)
-        return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=0 (write) */
-    TWI_write((uint8)(0xA0 | ((u16addr & 0x0700)>>7)));
-    if (TWI_getStatus() != TW_MT_SLA_W_ACK)
-        return ERROR; 
-		 
-    /* Send the required memory location address */
-    TWI_write((uint8)(u16addr));
-    if (TWI_getStatus() != TW_MT_DATA_ACK)
-        return ERROR;
-		
-    /* write byte to eeprom */
-    TWI_write(u8data);
-    if (TWI_getStatus() != TW_MT_DATA_ACK)
-        return ERROR;
-
-    /* Send the Stop Bit */
-    TWI_stop();
-	
-    return SUCCESS;
+    return EEPROM_writeBlock(u16addr, &u8data, 1);
 }
 
 uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
 {
-	/* Send the Start Bit */
-    TWI_start();
-    if (TWI_getStatus() != TW_START)
-        return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=0 (write) */
-    TWI_write((uint8)((0xA0) | ((u16addr & 0x0700)>>7)));
-    if (TWI_getStatus() != TW_MT_SLA_W_ACK)
-        return ERROR;
-		
-    /* Send the required memory location address */
-    TWI_write((uint8)(u16addr));
-    if (TWI_getStatus() != TW_MT_DATA_ACK)
+    return EEPROM_readBlock(u16addr, u8data, 1);
+}
+
+uint8 EEPROM_writeBlock(uint16 u16addr, const uint8 *u8data, uint16 u16length)
+{
+    TRACE_BEGIN(TRACE_EEPROM_WRITE, (uint8)u16length);
+    /* Wait for the running operation, the ISRs keep running meanwhile */
+    while (EEPROM_isBusy());
+    /* A request which timed out stopped the TWI queue, the blocking calls
+     * run out of the ISRs so they recover the bus themselves */
+    TWI_process();
+    if (EEPROM_writeBlockAsync(u16addr, u8data, u16length, NULL_PTR) == ERROR)
+        g_result = ERROR;
+    else
+        while (EEPROM_isBusy());
+    TWI_process();
+    TRACE_END(TRACE_EEPROM_WRITE, g_result);
+    return g_result;
+}
+
+uint8 EEPROM_readBlock(uint16 u16addr, uint8 *u8data, uint16 u16length)
+{
+    TRACE_BEGIN(TRACE_EEPROM_READ, (uint8)u16length);
+    /* Wait for the running operation, the ISRs keep running meanwhile */
+    while (EEPROM_isBusy());
+    /* A request which timed out stopped the TWI queue, the blocking calls
+     * run out of the ISRs so they recover the bus themselves */
+    TWI_process();
+    if (EEPROM_readBlockAsync(u16addr, u8data, u16length, NULL_PTR) == ERROR)
+        g_result = ERROR;
+    else
+        while (EEPROM_isBusy());
+    TWI_process();
+    TRACE_END(TRACE_EEPROM_READ, g_result);
+    return g_result;
+}
+
+uint8 EEPROM_writeBlockAsync(uint16 u16addr, const uint8 *u8data,\
+		uint16 u16length, void(*a_ptr)(uint8 result))
+{
+    if (g_busy)
         return ERROR;
-		
-    /* Send the Repeated Start Bit */
-    TWI_start();
-    if (TWI_getStatus() != TW_REP_START)
+    g_busy = TRUE;
+    g_callBackPtr = a_ptr;
+    g_address = u16addr;
+    g_dataPtr = u8data;
+    g_remaining = u16length;
+    if (u16length == 0)
+    {
+        EEPROM_finish(SUCCESS);
+        return SUCCESS;
+    }
+    if (EEPROM_writePage() == ERROR)
+    {
+        g_busy = FALSE;
         return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=1 (Read) */
-    TWI_write((uint8)((0xA0) | ((u16addr & 0x0700)>>7) | 1));
-    if (TWI_getStatus() != TW_MT_SLA_R_ACK)
+    }
+    return SUCCESS;
+}
+
+uint8 EEPROM_readBlockAsync(uint16 u16addr, uint8 *u8data,\
+		uint16 u16length, void(*a_ptr)(uint8 result))
+{
+    if (g_busy)
         return ERROR;
+    g_busy = TRUE;
+    g_callBackPtr = a_ptr;
+    g_remaining = 0;
+    if (u16length == 0)
+    {
+        EEPROM_finish(SUCCESS);
+        return SUCCESS;
+    }
 
-    /* Read Byte from Memory without send ACK */
-    *u8data = TWI_readWithNACK();
-    if (TWI_getStatus() != TW_MR_DATA_NACK)
+    /* Device address with A8 A9 A10 address bits, the word address, then a
+     * sequential read where the EEPROM increments its address after every
+     * ACK and the last byte is read with NACK */
+    g_buffer[0] = (uint8)(u16addr);
+    g_request.address = (uint8)(0xA0 | ((u16addr & 0x0700)>>7));
+    g_request.txData = g_buffer;
+    g_request.txLength = 1;
+    g_request.rxData = u8data;
+    g_request.rxLength = u16length;
+    /* Wait for the write cycle of the last page (ACK polling) */
+    g_request.polls = EEPROM_MAX_POLLS;
+    g_request.callBack = EEPROM_requestDone;
+    if (!TWI_submit(&g_request))
+    {
+        g_busy = FALSE;
         return ERROR;
+    }
+    return SUCCESS;
+}
+
+bool EEPROM_isBusy(void)
+{
+    return g_busy;
+}
+
+static uint8 EEPROM_writePage(void)
+{
+    uint8 u8count;
+    uint8 i;
+
+    /* Bytes left until the end of the current page */
+    u8count = EEPROM_PAGE_SIZE - (g_address & (EEPROM_PAGE_SIZE-1));
+    if (u8count > g_remaining)
+        u8count = g_remaining;
+
+    /* The word address and the page bytes are sent in the same transaction */
+    g_buffer[0] = (uint8)(g_address);
+    for (i = 0; i < u8count; i++)
+    {
+        g_buffer[1+i] = g_dataPtr[i];
+    }
+    g_request.address = (uint8)(0xA0 | ((g_address & 0x0700)>>7));
+    g_request.txData = g_buffer;
+    g_request.txLength = 1 + u8count;
+    g_request.rxLength = 0;
+    /* Wait for the write cycle of the last page (ACK polling) */
+    g_request.polls = EEPROM_MAX_POLLS;
+    g_request.callBack = EEPROM_requestDone;
 
-    /* Send the Stop Bit */
-    TWI_stop();
+    g_address += u8count;
+    g_dataPtr += u8count;
+    g_remaining -= u8count;
+
+    /* The STOP at the end of the request starts the write cycle of this page */
+    if (!TWI_submit(&g_request))
+        return ERROR;
     return SUCCESS;
 }
+
+static void EEPROM_requestDone(Twi_RequestType *request)
+{
+    if (request->state == TWI_TIMEOUT)
+    {
+        EEPROM_finish(EEPROM_TIMEOUT);
+    }
+    else if (request->state != TWI_DONE)
+    {
+        EEPROM_finish(ERROR);
+    }
+    else if (g_remaining > 0)
+    {
+        if (EEPROM_writePage() == ERROR)
+            EEPROM_finish(ERROR);
+    }
+    else
+    {
+        EEPROM_finish(SUCCESS);
+    }
+}
+
+static void EEPROM_finish(uint8 result)
+{
+    g_result = result;
+    g_busy = FALSE;
+    if (g_callBackPtr != NULL_PTR)
+    {
+        (*g_callBackPtr)(result);
+    }
+}
@@ -19,6 +19,27 @@
   ----------------------------------------------------------------------------*/
 #define ERROR 0
 #define SUCCESS 1
+/* The bus did not move for EEPROM_TIMEOUT_MS and it was recovered */
+#define EEPROM_TIMEOUT 2
+/* 24C16 page size, a page write must not cross a page boundary */
+#define EEPROM_PAGE_SIZE 16
+/* Maximum number of address polls while the EEPROM finishes its internal
+ * write cycle (tWR = 5 ms max, one poll START + SLA+W + STOP takes about
+ * 50 us at 400 Kb/s) */
+#define EEPROM_MAX_POLLS 400
+/* Time without any bus progress before the TWI request is given up */
+#define EEPROM_TIMEOUT_MS 20
+/*
+ * Worst-case latency of the blocking calls at 400 Kb/s, per page of the
+ * block (the byte calls are one page):
+ *   ACK polling of the last write cycle  EEPROM_MAX_POLLS * 50 us = 20 ms
+ *   transfer of up to 18 bytes           18 * 23 us              < 0.5 ms
+ *   stuck bus                            EEPROM_TIMEOUT_MS + 2 ticks of
+ *                                        TWI_TICK_MS + recovery   < 41 ms
+ * A page is either polled and moved or given up on a stuck bus, so the
+ * latency is bounded by about 41 ms per page. Every call returns SUCCESS,
+ * ERROR (NACK or bus error) or EEPROM_TIMEOUT.
+ */
 
 /* -----------------------------------------------------------------------------
  *                      Functions Prototypes                                   *
@@ -26,5 +47,16 @@
 void EEPROM_init(void);
 uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data);
 uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data);
+uint8 EEPROM_writeBlock(uint16 u16addr,const uint8 *u8data,uint16 u16length);
+uint8 EEPROM_readBlock(uint16 u16addr,uint8 *u8data,uint16 u16length);
+/*
+ * Non-blocking versions: they return ERROR if an operation is running,
+ * the buffer must stay valid until the callback (called from the TWI ISR)
+ */
+uint8 EEPROM_writeBlockAsync(uint16 u16addr,const uint8 *u8data,\
+		uint16 u16length,void(*a_ptr)(uint8 result));
+uint8 EEPROM_readBlockAsync(uint16 u16addr,uint8 *u8data,\
+		uint16 u16length,void(*a_ptr)(uint8 result));
+bool EEPROM_isBusy(void);
  
 #endif 
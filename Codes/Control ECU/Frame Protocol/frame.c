@@ -0,0 +1,369 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	frame.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Frame Protocol used between HMI ECU and Control ECU over
+					UART
+------------------------------------------------------------------------------*/
+
+#include "frame.h"
+
+/* -----------------------------------------------------------------------------
+ *                         Types Declaration                                   *
+ ------------------------------------------------------------------------------*/
+typedef enum{
+	FRAME_WAIT_SYNC,FRAME_WAIT_ADDRESS,FRAME_WAIT_TYPE,FRAME_WAIT_LENGTH,FRAME_WAIT_PAYLOAD,\
+	FRAME_WAIT_CRC
+}Frame_ParserState;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes(Private)                          *
+ ------------------------------------------------------------------------------*/
+/* Functions to put/get a 32-bit value in/from a payload, LSB first */
+static void FRAME_putUint32(uint8 *payload,const uint32 value);
+static uint32 FRAME_getUint32(const uint8 *payload);
+/* Function to hand the next queued frame to the UART, it runs with the UDRE
+ * interrupt unable to preempt it */
+static void FRAME_txNext(void);
+/* Call back function of the UART once the last byte of a frame is in UDR */
+static void FRAME_txDone(void);
+/* Function to find the last frame sent to an address */
+static Frame_Type *FRAME_findLast(const uint8 address);
+
+/* -----------------------------------------------------------------------------
+ *                           Global Variables                                  *
+-------------------------------------------------------------------------------*/
+/* State of the receive parser */
+static volatile Frame_ParserState g_parserState=FRAME_WAIT_SYNC;
+static uint8 g_parserIndex;
+static uint8 g_parserCrc;
+/* Ticks since the last byte parsed, counted by FRAME_tick */
+static volatile uint8 g_parserIdleTicks=0;
+/* Frame under reception, copied to the caller only when it is complete */
+static Frame_Type g_rxFrame;
+/* Copies of the last frame sent to each address to be sent again when the
+ * other ECU asks, the oldest address is replaced by a new one */
+static Frame_Type g_lastFrames[FRAME_LAST_FRAMES];
+static uint8 g_lastFrameOldest=0;
+/* Frame bytes being sent by the UART UDRE interrupt */
+static uint8 g_txBuffer[FRAME_MAX_PAYLOAD+FRAME_OVERHEAD];
+/* Frames waiting for g_txBuffer: written by FRAME_send (head), read by
+ * FRAME_txNext (tail) */
+static uint8 g_txQueue[FRAME_TX_QUEUE_SIZE];
+static volatile uint8 g_txQueueHead=0;
+static volatile uint8 g_txQueueTail=0;
+/* g_txBuffer is owned by the UART */
+static volatile bool g_txActive=FALSE;
+/* Function called when the UART finishes sending a frame */
+static void (* volatile g_txCallBackPtr)(void) = NULL_PTR;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Definitions                                  *
+ ------------------------------------------------------------------------------*/
+void FRAME_init(void){
+	uint8 i;
+	g_parserState=FRAME_WAIT_SYNC;
+	for(i=0;i<FRAME_LAST_FRAMES;i++){
+		g_lastFrames[i].address=UART_BROADCAST_ADDRESS;
+		g_lastFrames[i].type=FRAME_NACK;
+		g_lastFrames[i].length=0;
+	}
+	g_lastFrameOldest=0;
+}
+
+void FRAME_setTxCallBack(void(*a_ptr)(void)){
+	g_txCallBackPtr=a_ptr;
+}
+
+bool FRAME_send(const uint8 address,const uint8 type,const uint8 *payload,\
+		const uint8 length){
+	uint8 i,head;
+	uint8 crc=FRAME_CRC_INITIAL;
+	uint8 sreg;
+	Frame_Type *last;
+	/* The frame is queued with its address and size */
+	if((length > FRAME_MAX_PAYLOAD) ||\
+			((uint8)(FRAME_TX_QUEUE_MASK-((g_txQueueHead-g_txQueueTail) &\
+			FRAME_TX_QUEUE_MASK)) < (length+FRAME_OVERHEAD+2))){
+		return FALSE;
+	}
+	/* Keep a copy of every frame except the NACK itself to answer a NACK,
+	 * a broadcast frame is never asked for by one ECU */
+	if((type != FRAME_NACK) && (address != UART_BROADCAST_ADDRESS)){
+		last=FRAME_findLast(address);
+		if(last == NULL_PTR){
+			last=&g_lastFrames[g_lastFrameOldest];
+			g_lastFrameOldest=(g_lastFrameOldest+1) % FRAME_LAST_FRAMES;
+		}
+		last -> address=address;
+		last -> type=type;
+		last -> length=length;
+		for(i=0;i<length;i++){
+			last -> payload[i]=payload[i];
+		}
+	}
+	head=g_txQueueHead;
+	g_txQueue[head]=address;
+	head=(head+1) & FRAME_TX_QUEUE_MASK;
+	g_txQueue[head]=length+FRAME_OVERHEAD;
+	head=(head+1) & FRAME_TX_QUEUE_MASK;
+	g_txQueue[head]=FRAME_SYNC;
+	head=(head+1) & FRAME_TX_QUEUE_MASK;
+	g_txQueue[head]=address;
+	head=(head+1) & FRAME_TX_QUEUE_MASK;
+	crc=FRAME_crc8(crc,address);
+	g_txQueue[head]=type;
+	head=(head+1) & FRAME_TX_QUEUE_MASK;
+	crc=FRAME_crc8(crc,type);
+	g_txQueue[head]=length;
+	head=(head+1) & FRAME_TX_QUEUE_MASK;
+	crc=FRAME_crc8(crc,length);
+	for(i=0;i<length;i++){
+		g_txQueue[head]=payload[i];
+		head=(head+1) & FRAME_TX_QUEUE_MASK;
+		crc=FRAME_crc8(crc,payload[i]);
+	}
+	g_txQueue[head]=crc;
+	g_txQueueHead=(head+1) & FRAME_TX_QUEUE_MASK;
+	/* Return at once, the frame is sent by the UART UDRE interrupt and the
+	 * next one is started from it */
+	sreg=SREG;
+	CLEAR_BIT(SREG,7);
+	if(!g_txActive){
+		FRAME_txNext();
+	}
+	SREG=sreg;
+	return TRUE;
+}
+
+bool FRAME_isTxBusy(void){
+	return g_txActive || (g_txQueueHead != g_txQueueTail);
+}
+
+bool FRAME_resend(const uint8 address){
+	/* Every ECU asks for the last frame sent to it */
+	Frame_Type *last=FRAME_findLast(address);
+	if(last == NULL_PTR){
+		return FALSE;
+	}
+	return FRAME_send(last -> address,last -> type,last -> payload,\
+			last -> length);
+}
+
+Frame_Status FRAME_parseByte(const uint8 data,Frame_Type *frame){
+	g_parserIdleTicks=0;
+	switch(g_parserState){
+	case FRAME_WAIT_SYNC:
+		/* Any byte out of a frame is ignored until the next SYNC byte */
+		if(data == FRAME_SYNC){
+			g_parserCrc=FRAME_CRC_INITIAL;
+			g_parserState=FRAME_WAIT_ADDRESS;
+		}
+		break;
+	case FRAME_WAIT_ADDRESS:
+		g_rxFrame.address=data;
+		g_parserCrc=FRAME_crc8(g_parserCrc,data);
+		g_parserState=FRAME_WAIT_TYPE;
+		break;
+	case FRAME_WAIT_TYPE:
+		g_rxFrame.type=data;
+		g_parserCrc=FRAME_crc8(g_parserCrc,data);
+		g_parserState=FRAME_WAIT_LENGTH;
+		break;
+	case FRAME_WAIT_LENGTH:
+		if(data > FRAME_MAX_PAYLOAD){
+			g_parserState=FRAME_WAIT_SYNC;
+			frame -> address=g_rxFrame.address;
+			return FRAME_CORRUPTED;
+		}
+		g_rxFrame.length=data;
+		g_parserCrc=FRAME_crc8(g_parserCrc,data);
+		g_parserIndex=0;
+		g_parserState=(data == 0) ? FRAME_WAIT_CRC : FRAME_WAIT_PAYLOAD;
+		break;
+	case FRAME_WAIT_PAYLOAD:
+		g_rxFrame.payload[g_parserIndex]=data;
+		g_parserCrc=FRAME_crc8(g_parserCrc,data);
+		g_parserIndex++;
+		if(g_parserIndex == g_rxFrame.length){
+			g_parserState=FRAME_WAIT_CRC;
+		}
+		break;
+	case FRAME_WAIT_CRC:
+		g_parserState=FRAME_WAIT_SYNC;
+		if(data != g_parserCrc){
+			/* The address tells which ECU to ask for the frame again */
+			frame -> address=g_rxFrame.address;
+			return FRAME_CORRUPTED;
+		}
+		*frame=g_rxFrame;
+		return FRAME_COMPLETE;
+	}
+	return FRAME_INCOMPLETE;
+}
+
+Frame_Status FRAME_receive(Frame_Type *frame){
+	uint8 data;
+	Frame_Status status;
+	/* Consume the buffered bytes without blocking until a frame ends */
+	while(UART_read(&data)){
+		status=FRAME_parseByte(data,frame);
+		if(status != FRAME_INCOMPLETE){
+			return status;
+		}
+	}
+	/* A frame whose last bytes are lost is dropped, no byte may come to end
+	 * it. The address is known once it is received */
+	if((g_parserState != FRAME_WAIT_SYNC) &&\
+			(g_parserIdleTicks >= FRAME_BYTE_TIMEOUT_TICKS)){
+		frame -> address=(g_parserState == FRAME_WAIT_ADDRESS) ?\
+				UART_BROADCAST_ADDRESS : g_rxFrame.address;
+		g_parserState=FRAME_WAIT_SYNC;
+		return FRAME_CORRUPTED;
+	}
+	return FRAME_INCOMPLETE;
+}
+
+bool FRAME_tick(void){
+	if(g_parserIdleTicks >= FRAME_BYTE_TIMEOUT_TICKS){
+		return FALSE;
+	}
+	g_parserIdleTicks++;
+	return (g_parserIdleTicks == FRAME_BYTE_TIMEOUT_TICKS) &&\
+			(g_parserState != FRAME_WAIT_SYNC);
+}
+
+void FRAME_flush(void){
+	uint8 data;
+	while(UART_read(&data)){}
+	g_parserState=FRAME_WAIT_SYNC;
+}
+
+/*---------------------------- Baud Rate Negotiation ---------------------------
+ * All ECUs start at UART_DEFAULT_BAUD. After FRAME_READY each HMI ECU offers
+ * its supported baud rates, the Control ECU selects the fastest one supported
+ * by all of them and broadcasts it, then all ECUs switch to it. Each panel
+ * sends the select frame back at the new baud rate and the Control ECU sends
+ * it again to confirm, a switch which is not confirmed in time takes all
+ * ECUs back to UART_DEFAULT_BAUD. A panel which did not answer is sent
+ * FRAME_READY again at the selected baud rate, which it finds by trying its
+ * supported baud rates in turn, and it is sent the select frame once it
+ * offers them.
+ -----------------------------------------------------------------------------*/
+void FRAME_offerBaudRates(const uint8 address){
+	uint8 payload[FRAME_MAX_PAYLOAD];
+	uint8 i=0;
+	uint32 baudRate=UART_getSupportedBaudRate(0);
+	while((baudRate != 0) && ((4*i) < FRAME_MAX_PAYLOAD)){
+		FRAME_putUint32(payload+(4*i),baudRate);
+		i++;
+		baudRate=UART_getSupportedBaudRate(i);
+	}
+	FRAME_send(address,FRAME_BAUD_OFFER,payload,4*i);
+}
+
+uint32 FRAME_commonBaudRate(const Frame_Type *offer,const uint32 limit){
+	uint8 i;
+	uint32 baudRate;
+	uint32 selected=UART_DEFAULT_BAUD;
+	/* Fastest baud rate offered by the other ECU, supported by this one and
+	 * not faster than the limit (the rate common with the other slaves) */
+	for(i=0;i<(offer -> length);i+=4){
+		baudRate=FRAME_getUint32(offer -> payload+i);
+		if(UART_isBaudRateSupported(baudRate) && (baudRate > selected) &&\
+				(baudRate <= limit)){
+			selected=baudRate;
+		}
+	}
+	return selected;
+}
+
+bool FRAME_selectBaudRate(const uint8 address,const uint32 baudRate){
+	/* No ECU switches if the select frame is not queued */
+	if(!FRAME_sendBaudRate(address,baudRate)){
+		return FALSE;
+	}
+	/* Switch after the select frame is sent with the old baud rate */
+	while(FRAME_isTxBusy()){}
+	return UART_setBaudRate(baudRate);
+}
+
+bool FRAME_sendBaudRate(const uint8 address,const uint32 baudRate){
+	uint8 payload[4];
+	FRAME_putUint32(payload,baudRate);
+	return FRAME_send(address,FRAME_BAUD_SELECT,payload,4);
+}
+
+uint32 FRAME_applyBaudRate(const Frame_Type *select){
+	uint32 baudRate;
+	if(select -> length != 4){
+		return 0;
+	}
+	baudRate=FRAME_getUint32(select -> payload);
+	/* The queued frames are sent with the old baud rate */
+	while(FRAME_isTxBusy()){}
+	if(!UART_setBaudRate(baudRate)){
+		return 0;
+	}
+	/* Drop any byte received during the switch */
+	FRAME_flush();
+	return baudRate;
+}
+
+static void FRAME_putUint32(uint8 *payload,const uint32 value){
+	payload[0]=(uint8)value;
+	payload[1]=(uint8)(value>>8);
+	payload[2]=(uint8)(value>>16);
+	payload[3]=(uint8)(value>>24);
+}
+
+static uint32 FRAME_getUint32(const uint8 *payload){
+	return ((uint32)payload[0]) | ((uint32)payload[1]<<8) |\
+			((uint32)payload[2]<<16) | ((uint32)payload[3]<<24);
+}
+
+static void FRAME_txNext(void){
+	uint8 tail=g_txQueueTail;
+	uint8 address,size,i;
+	/* The UART is only left busy by bytes written out of the frames, the
+	 * next FRAME_send starts the queue again */
+	g_txActive=FALSE;
+	if((tail == g_txQueueHead) || UART_isTxBusy()){
+		return;
+	}
+	address=g_txQueue[tail];
+	tail=(tail+1) & FRAME_TX_QUEUE_MASK;
+	size=g_txQueue[tail];
+	tail=(tail+1) & FRAME_TX_QUEUE_MASK;
+	for(i=0;i<size;i++){
+		g_txBuffer[i]=g_txQueue[tail];
+		tail=(tail+1) & FRAME_TX_QUEUE_MASK;
+	}
+	g_txQueueTail=tail;
+	/* On a multi-processor bus wake up the addressed slave only, both calls
+	 * succeed as the UART is not busy */
+	UART_sendAddress(address);
+	g_txActive=UART_sendAsync(g_txBuffer,size,FRAME_txDone);
+}
+
+static void FRAME_txDone(void){
+	/* The last byte is in UDR so g_txBuffer is free for the next frame */
+	FRAME_txNext();
+	if(g_txCallBackPtr != NULL_PTR){
+		(*g_txCallBackPtr)();
+	}
+}
+
+static Frame_Type *FRAME_findLast(const uint8 address){
+	uint8 i;
+	for(i=0;i<FRAME_LAST_FRAMES;i++){
+		if((g_lastFrames[i].address == address) &&\
+				(g_lastFrames[i].type != FRAME_NACK)){
+			return &g_lastFrames[i];
+		}
+	}
+	return NULL_PTR;
+}
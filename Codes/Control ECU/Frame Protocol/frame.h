@@ -0,0 +1,116 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	frame.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Header File for the Frame Protocol used between HMI ECU
+					and Control ECU over UART
+------------------------------------------------------------------------------*/
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include "../Important Heading Files/std_types.h"
+#include "../Important Heading Files/common_macros.h"
+#include "../UART/uart.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Preprocessor Macros                                    *
+ ------------------------------------------------------------------------------*/
+/*-------------------------- Frame Description ---------------------------------
+ * | SYNC | ADDRESS | TYPE | LENGTH | PAYLOAD (LENGTH bytes) | CRC-8 |
+ * SYNC    : Fixed byte marking the start of every frame
+ * ADDRESS : HMI panel address, the destination of frames sent by Control ECU
+ *           and the source of frames sent by HMI ECU
+ * TYPE    : One of Frame_MessageType
+ * LENGTH  : Number of payload bytes (0 .. FRAME_MAX_PAYLOAD)
+ * CRC-8   : Polynomial 0x07 over ADDRESS, TYPE, LENGTH and PAYLOAD
+ -----------------------------------------------------------------------------*/
+#define FRAME_SYNC 0x7E
+#define FRAME_MAX_PAYLOAD 32
+#define FRAME_CRC_POLYNOMIAL 0x07
+#define FRAME_CRC_INITIAL 0x00
+/* SYNC, ADDRESS, TYPE, LENGTH and CRC bytes added to the payload */
+#define FRAME_OVERHEAD 5
+/* Frames waiting for the UART, each one as | ADDRESS | SIZE | FRAME |. It
+ * must be a power of two not more than 256 and hold one full frame */
+#define FRAME_TX_QUEUE_SIZE 64
+#define FRAME_TX_QUEUE_MASK (FRAME_TX_QUEUE_SIZE-1)
+
+#if ((FRAME_TX_QUEUE_SIZE & FRAME_TX_QUEUE_MASK) != 0) ||\
+	(FRAME_TX_QUEUE_SIZE > 256)
+#error "FRAME_TX_QUEUE_SIZE must be a power of two not more than 256"
+#endif
+#if (FRAME_TX_QUEUE_SIZE <= FRAME_MAX_PAYLOAD+FRAME_OVERHEAD+2)
+#error "FRAME_TX_QUEUE_SIZE must hold a frame of FRAME_MAX_PAYLOAD"
+#endif
+/* Number of addresses whose last frame is kept to answer their NACK, the
+ * Control ECU needs one per HMI panel */
+#define FRAME_LAST_FRAMES 2
+/* Ticks of FRAME_tick without a byte in the middle of a frame before the
+ * frame is dropped as corrupted, a lost byte leaves no frame waiting */
+#define FRAME_BYTE_TIMEOUT_TICKS 3
+
+#ifndef NULL_PTR
+#define NULL_PTR (void *) 0
+#endif
+
+/* -----------------------------------------------------------------------------
+ *                         Types Declaration                                   *
+ ------------------------------------------------------------------------------*/
+typedef enum{
+	FRAME_READY=1,FRAME_SET_PASSWORD,FRAME_OPEN_DOOR,FRAME_CHANGE_PASSWORD,\
+	FRAME_STATUS,FRAME_NACK,FRAME_BAUD_OFFER,FRAME_BAUD_SELECT,FRAME_DIGIT,\
+	FRAME_AUDIT,FRAME_POWER,FRAME_TRACE,FRAME_DOOR
+}Frame_MessageType;
+
+typedef enum{
+	FRAME_INCOMPLETE,FRAME_COMPLETE,FRAME_CORRUPTED
+}Frame_Status;
+
+typedef struct{
+	uint8 address;
+	uint8 type;
+	uint8 length;
+	uint8 payload[FRAME_MAX_PAYLOAD];
+}Frame_Type;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes                                   *
+ ------------------------------------------------------------------------------*/
+void FRAME_init(void);
+/* Queue a frame and return at once, the UART UDRE interrupt sends the
+ * queued frames in order. It returns FALSE and drops the frame if the queue
+ * is full, it can be sent again once the TX call back function is called */
+bool FRAME_send(const uint8 address,const uint8 type,const uint8 *payload,\
+		const uint8 length);
+/* Returns TRUE while a frame is queued or sent */
+bool FRAME_isTxBusy(void);
+/* Function called from the UART UDRE ISR every time a frame is sent */
+void FRAME_setTxCallBack(void(*a_ptr)(void));
+/* Send the last frame sent to this address again, returns FALSE if there is
+ * none or the queue is full */
+bool FRAME_resend(const uint8 address);
+/* On FRAME_CORRUPTED only the address of the frame is stored, it can be
+ * corrupted too */
+Frame_Status FRAME_parseByte(const uint8 data,Frame_Type *frame);
+/* FRAME_CORRUPTED is returned too once a frame stops for
+ * FRAME_BYTE_TIMEOUT_TICKS */
+Frame_Status FRAME_receive(Frame_Type *frame);
+/* Called from a periodic tick ISR, returns TRUE at the tick a frame under
+ * reception times out so the caller can call FRAME_receive */
+bool FRAME_tick(void);
+void FRAME_flush(void);
+/* CRC-8 of the frames, in frame_crc.c so the PC tools can link it alone */
+uint8 FRAME_crc8(uint8 crc,const uint8 data);
+void FRAME_offerBaudRates(const uint8 address);
+uint32 FRAME_commonBaudRate(const Frame_Type *offer,const uint32 limit);
+bool FRAME_selectBaudRate(const uint8 address,const uint32 baudRate);
+/* Send the select frame without switching, to a panel which joins the bus
+ * at its baud rate */
+bool FRAME_sendBaudRate(const uint8 address,const uint32 baudRate);
+uint32 FRAME_applyBaudRate(const Frame_Type *select);
+
+#endif
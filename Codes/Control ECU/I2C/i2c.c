@@ -10,9 +10,135 @@
 
 #include "i2c.h"
 
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+/* Request queue: written by TWI_submit (head), served by the TWI ISR (tail) */
+static Twi_RequestType * volatile g_queue[TWI_QUEUE_SIZE];
+static volatile uint8 g_queueHead=0;
+static volatile uint8 g_queueTail=0;
+/* The ISR is running the request at the queue tail */
+static volatile bool g_busy=FALSE;
+/* Progress of the running request */
+static volatile uint16 g_index;
+static volatile uint16 g_polls;
+static volatile bool g_reading;
+/* Last configuration, used again after a bus recovery */
+static Twi_ConfigType g_config;
+/* Timeout in TWI_tick calls, 0 if the timeouts are disabled */
+static uint8 g_timeoutTicks=0;
+/* TWI_tick calls left before the running request times out */
+static volatile uint8 g_countdown;
+/* TWI_tick calls, measures the waits of the polling functions */
+static volatile uint8 g_ticks=0;
+/* The last wait of a polling function timed out */
+static bool g_timedOut=FALSE;
+/* A request timed out, the queue waits for TWI_process to recover the bus */
+static volatile bool g_recoveryPending=FALSE;
+static void (*volatile g_recoveryCallBackPtr)(void)=NULL_PTR;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes(Private)                          *
+ ------------------------------------------------------------------------------*/
+/* Function responsible for ending the running request and starting the next */
+static void TWI_finish(Twi_RequestState state);
+/* Function responsible for removing the running request from the queue */
+static void TWI_complete(Twi_RequestState state);
+/* Function responsible for waiting for TWINT with a timeout */
+static void TWI_wait(void);
+/* Function responsible for starting the request at the queue tail */
+static void TWI_startNext(void);
+
+/* ----------------------------------------------------------------------------
+ *                          ISR's Definitions                                 *
+------------------------------------------------------------------------------*/
+ISR(TWI_vect)
+{
+	Twi_RequestType *request = g_queue[g_queueTail];
+	/* The bus moved, restart the timeout of the request */
+	g_countdown = g_timeoutTicks;
+	switch(TWSR & 0xF8)
+	{
+	case TW_START:
+		/* The request starts with its write phase if it has one */
+		g_reading = (request->txLength == 0) && (request->rxLength != 0);
+		g_index = 0;
+		TWDR = request->address | g_reading;
+		TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+		break;
+	case TW_REP_START:
+		g_reading = TRUE;
+		g_index = 0;
+		TWDR = request->address | 1;
+		TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+		break;
+	case TW_MT_SLA_W_ACK:
+	case TW_MT_DATA_ACK:
+		if(g_index < request->txLength)
+		{
+			TWDR = request->txData[g_index];
+			g_index++;
+			TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+		}
+		else if(request->rxLength != 0)
+		{
+			/* Write phase is done, turn the bus around for reading */
+			TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
+		}
+		else
+		{
+			TWI_finish(TWI_DONE);
+		}
+		break;
+	case TW_MT_SLA_W_NACK:
+	case TW_MR_SLA_R_NACK:
+		if(g_polls != 0)
+		{
+			/* The slave is busy (EEPROM write cycle), send STOP then START */
+			g_polls--;
+			TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWSTA) | (1 << TWEN) |\
+					(1 << TWIE);
+		}
+		else
+		{
+			TWI_finish(TWI_FAILED);
+		}
+		break;
+	case TW_MR_DATA_ACK:
+		/* Store the byte then ask for the next one as after SLA+R */
+		request->rxData[g_index] = TWDR;
+		g_index++;
+		/* fall through */
+	case TW_MT_SLA_R_ACK:
+		/* Send ACK after every byte but the last one */
+		if(g_index+1 < request->rxLength)
+		{
+			TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWEA) | (1 << TWIE);
+		}
+		else
+		{
+			TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+		}
+		break;
+	case TW_MR_DATA_NACK:
+		request->rxData[g_index] = TWDR;
+		TWI_finish(TWI_DONE);
+		break;
+	default:
+		/* Data NACK, lost arbitration or bus error */
+		TWI_finish(TWI_FAILED);
+		break;
+	}
+}
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+
 void TWI_init(const Twi_ConfigType * Config_Ptr)
 {
-	sint8 twbrValue = (float)(((F_CPU/Config_Ptr->speed)-16)/(2*Config_Ptr->prescalar));
+	/* SCL = F_CPU/(16+2*TWBR*4^TWPS) */
+	uint8 twbrValue = (uint8)(((F_CPU/Config_Ptr->speed)-16)/(2*(1<<(2*Config_Ptr->prescalar))));
 	TWBR = twbrValue;
 	TWSR = Config_Ptr->prescalar;
 
@@ -21,6 +147,22 @@ void TWI_init(const Twi_ConfigType * Config_Ptr)
 	TWAR = Config_Ptr->address;
 
 	TWCR = (1<<TWEN); /* enable TWI */
+
+	/* Keep the configuration for the bus recovery. One tick is added as the
+	 * first tick can come at once */
+	g_config = *Config_Ptr;
+	if(Config_Ptr->timeout == 0)
+	{
+		g_timeoutTicks = 0;
+	}
+	else if(Config_Ptr->timeout >= 254*TWI_TICK_MS)
+	{
+		g_timeoutTicks = 255;
+	}
+	else
+	{
+		g_timeoutTicks = ((Config_Ptr->timeout+TWI_TICK_MS-1)/TWI_TICK_MS)+1;
+	}
 }
 
 void TWI_start(void)
@@ -33,7 +175,7 @@ void TWI_start(void)
 	TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
 
 	/* Wait for TWINT flag set in TWCR Register (start bit is send successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
+	TWI_wait();
 }
 
 void TWI_stop(void)
@@ -56,7 +198,7 @@ void TWI_write(uint8 data)
 	 */ 
 	TWCR = (1 << TWINT) | (1 << TWEN);
 	/* Wait for TWINT flag set in TWCR Register(data is send successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
+	TWI_wait();
 }
 
 uint8 TWI_readWithACK(void)
@@ -68,7 +210,7 @@ uint8 TWI_readWithACK(void)
 	 */ 
 	TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWEA);
 	/* Wait for TWINT flag set in TWCR Register (data received successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
+	TWI_wait();
 	/* Read Data */
 	return TWDR;
 }
@@ -81,7 +223,7 @@ uint8 TWI_readWithNACK(void)
 	 */
 	TWCR = (1 << TWINT) | (1 << TWEN);
 	/* Wait for TWINT flag set in TWCR Register (data received successfully) */
-	while(BIT_IS_CLEAR(TWCR,TWINT));
+	TWI_wait();
 	/* Read Data */
 	return TWDR;
 }
@@ -89,7 +231,189 @@ uint8 TWI_readWithNACK(void)
 uint8 TWI_getStatus(void)
 {
 	uint8 status;
+	if(g_timedOut)
+	{
+		return TW_TIMEOUT;
+	}
 	/* masking to eliminate first 3 bits and get the last 5 bits (status bits) */
 	status = TWSR & 0xF8;
 	return status;
 }
+
+bool TWI_submit(Twi_RequestType *request)
+{
+	uint8 sreg = SREG;
+	uint8 next;
+	/* The queue is also written from the completion callbacks in the ISR */
+	CLEAR_BIT(SREG,7);
+	next = (g_queueHead+1) & TWI_QUEUE_MASK;
+	if(next == g_queueTail)
+	{
+		SREG = sreg;
+		return FALSE;
+	}
+	request->state = TWI_QUEUED;
+	g_queue[g_queueHead] = request;
+	g_queueHead = next;
+	if(!g_busy)
+	{
+		g_busy = TRUE;
+		TWI_startNext();
+	}
+	SREG = sreg;
+	return TRUE;
+}
+
+bool TWI_isBusy(void)
+{
+	return g_busy;
+}
+
+void TWI_tick(void)
+{
+	g_ticks++;
+	if(!g_busy || g_recoveryPending || (g_timeoutTicks == 0))
+	{
+		return;
+	}
+	g_countdown--;
+	if(g_countdown != 0)
+	{
+		return;
+	}
+	/* No TWI interrupt during the whole timeout, the bus is stuck. The TWI
+	 * module is stopped and the queue stays busy, the new requests wait in
+	 * it until TWI_process recovers the bus */
+	TWCR = 0;
+	g_recoveryPending = TRUE;
+	TWI_complete(TWI_TIMEOUT);
+	if(g_recoveryCallBackPtr != NULL_PTR)
+	{
+		(*g_recoveryCallBackPtr)();
+	}
+}
+
+void TWI_setRecoveryCallBack(void(*a_ptr)(void))
+{
+	g_recoveryCallBackPtr = a_ptr;
+}
+
+void TWI_process(void)
+{
+	uint8 sreg;
+	if(!g_recoveryPending)
+	{
+		return;
+	}
+	/* The TWI module is stopped, so nothing else uses the bus meanwhile */
+	TWI_recover();
+	sreg = SREG;
+	CLEAR_BIT(SREG,7);
+	g_recoveryPending = FALSE;
+	if(g_queueTail != g_queueHead)
+	{
+		TWI_startNext();
+	}
+	else
+	{
+		g_busy = FALSE;
+	}
+	SREG = sreg;
+}
+
+void TWI_recover(void)
+{
+	uint8 i;
+	/* Take the pins from the TWI module, a pin is driven low by making it an
+	 * output and released by making it an input (the bus has pull-ups) */
+	TWCR = 0;
+	CLEAR_BIT(TWI_PORT,TWI_SCL);
+	CLEAR_BIT(TWI_PORT,TWI_SDA);
+	CLEAR_BIT(TWI_PORT_DIR,TWI_SCL);
+	CLEAR_BIT(TWI_PORT_DIR,TWI_SDA);
+	_delay_us(TWI_RECOVERY_DELAY_US);
+
+	/* A slave holding SDA low waits for the clocks of the byte it sends */
+	for(i = 0; (i < 9) && BIT_IS_CLEAR(TWI_PORT_IN,TWI_SDA); i++)
+	{
+		SET_BIT(TWI_PORT_DIR,TWI_SCL);
+		_delay_us(TWI_RECOVERY_DELAY_US);
+		CLEAR_BIT(TWI_PORT_DIR,TWI_SCL);
+		_delay_us(TWI_RECOVERY_DELAY_US);
+	}
+
+	/* STOP: SDA goes high while SCL is high */
+	SET_BIT(TWI_PORT_DIR,TWI_SCL);
+	SET_BIT(TWI_PORT_DIR,TWI_SDA);
+	_delay_us(TWI_RECOVERY_DELAY_US);
+	CLEAR_BIT(TWI_PORT_DIR,TWI_SCL);
+	_delay_us(TWI_RECOVERY_DELAY_US);
+	CLEAR_BIT(TWI_PORT_DIR,TWI_SDA);
+	_delay_us(TWI_RECOVERY_DELAY_US);
+
+	TWI_init(&g_config);
+}
+
+static void TWI_wait(void)
+{
+	uint8 start = g_ticks;
+	g_timedOut = FALSE;
+	/* Wait for TWINT, or recover the bus if it takes longer than the timeout */
+	while(BIT_IS_CLEAR(TWCR,TWINT))
+	{
+		if((g_timeoutTicks != 0) && ((uint8)(g_ticks-start) >= g_timeoutTicks))
+		{
+			g_timedOut = TRUE;
+			TWI_recover();
+			return;
+		}
+	}
+}
+
+static void TWI_startNext(void)
+{
+	uint8 wait;
+	g_polls = g_queue[g_queueTail]->polls;
+	g_countdown = g_timeoutTicks;
+	/* Wait for the STOP of the last request to be sent. If the bus holds it
+	 * the START is not sent and the request times out like a request which
+	 * stops on the bus */
+	for(wait = 0; BIT_IS_SET(TWCR,TWSTO); wait++)
+	{
+		if(wait == TWI_STOP_WAIT_US)
+		{
+			return;
+		}
+		_delay_us(1);
+	}
+	TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
+}
+
+static void TWI_complete(Twi_RequestState state)
+{
+	Twi_RequestType *request = g_queue[g_queueTail];
+	g_queueTail = (g_queueTail+1) & TWI_QUEUE_MASK;
+	request->state = state;
+	/* The callback can submit the next request, it is started by the caller */
+	if(request->callBack != NULL_PTR)
+	{
+		(*request->callBack)(request);
+	}
+}
+
+static void TWI_finish(Twi_RequestState state)
+{
+	TWI_complete(state);
+	if(g_queueTail != g_queueHead)
+	{
+		/* Send STOP followed by START of the next request */
+		g_polls = g_queue[g_queueTail]->polls;
+		TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWSTA) | (1 << TWEN) |\
+				(1 << TWIE);
+	}
+	else
+	{
+		g_busy = FALSE;
+		TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
+	}
+}
@@ -35,8 +35,33 @@ typedef struct
 	Twi_Speed speed;
 	Twi_Prescalar prescalar;
 	uint8 address;
+	uint16 timeout; /* ms without bus progress before recovery, 0 = never */
 }Twi_ConfigType;
 
+typedef enum
+{
+	TWI_QUEUED,TWI_DONE,TWI_FAILED,TWI_TIMEOUT
+}Twi_RequestState;
+
+/*
+ * Transaction descriptor owned by the caller and run by the TWI ISR:
+ * START, SLA+W and txData, then REPEATED START, SLA+R and rxData. A request
+ * with txLength = 0 only reads and a request with rxLength = 0 only writes.
+ * The descriptor and its buffers must stay valid until state is not
+ * TWI_QUEUED, the callback (if any) is called from the ISR at that moment.
+ */
+typedef struct Twi_Request
+{
+	uint8 address; /* slave address shifted left, the R/W bit is added */
+	const uint8 *txData;
+	uint16 txLength;
+	uint8 *rxData;
+	uint16 rxLength;
+	uint16 polls; /* times the address is sent again while it is not ACKed */
+	void (*callBack)(struct Twi_Request *request);
+	volatile Twi_RequestState state;
+}Twi_RequestType;
+
 /* ----------------------------------------------------------------------------
  *                      Preprocessor Macros                                   *
   ----------------------------------------------------------------------------*/
@@ -44,10 +69,40 @@ typedef struct
 #define TW_START         0x08 // start has been sent
 #define TW_REP_START     0x10 // repeated start 
 #define TW_MT_SLA_W_ACK  0x18 // Master transmit ( slave address + Write request ) to slave + Ack received from slave
+#define TW_MT_SLA_W_NACK 0x20 // Master transmit ( slave address + Write request ) to slave + Nack received from slave
 #define TW_MT_SLA_R_ACK  0x40 // Master transmit ( slave address + Read request ) to slave + Ack received from slave
 #define TW_MT_DATA_ACK   0x28 // Master transmit data and ACK has been received from Slave.
 #define TW_MR_DATA_ACK   0x50 // Master received data and send ACK to slave
+#define TW_MR_SLA_R_NACK 0x48 // Master transmit ( slave address + Read request ) to slave + Nack received from slave
 #define TW_MR_DATA_NACK  0x58 // Master received data but doesn't send ACK to slave
+#define TW_TIMEOUT       0xF8 // No state information, the last wait timed out and the bus was recovered
+
+/* TWI_tick must be called every TWI_TICK_MS from a timer interrupt, it
+ * measures the timeouts of the polling functions and of the requests */
+#define TWI_TICK_MS 10
+/* SCL and SDA pins, driven by software to recover a stuck bus */
+#define TWI_PORT PORTC
+#define TWI_PORT_DIR DDRC
+#define TWI_PORT_IN PINC
+#define TWI_SCL PC0
+#define TWI_SDA PC1
+/* Half period of the SCL pulses sent to recover the bus (100 KHz) */
+#define TWI_RECOVERY_DELAY_US 5
+/* Longest wait for the STOP of the last request before the next START, 10
+ * SCL periods at 100 KHz. A STOP which takes longer is a stuck bus */
+#define TWI_STOP_WAIT_US 100
+
+/* Number of requests waiting for the TWI bus, must be a power of two */
+#define TWI_QUEUE_SIZE 4
+#define TWI_QUEUE_MASK (TWI_QUEUE_SIZE-1)
+
+#if ((TWI_QUEUE_SIZE & TWI_QUEUE_MASK) != 0) || (TWI_QUEUE_SIZE > 256)
+#error "TWI_QUEUE_SIZE must be a power of two not more than 256"
+#endif
+
+#ifndef NULL_PTR
+#define NULL_PTR (void *) 0
+#endif
 
 /* -----------------------------------------------------------------------------
  *                      Functions Prototypes                                   *
@@ -59,6 +114,26 @@ void TWI_write(uint8 data);
 uint8 TWI_readWithACK(void); //read with send Ack
 uint8 TWI_readWithNACK(void); //read without send Ack
 uint8 TWI_getStatus(void);
+/*
+ * Interrupt driven requests, they need the I-bit and must not be mixed with
+ * the polling functions above while a request is running
+ */
+bool TWI_submit(Twi_RequestType *request);
+bool TWI_isBusy(void);
+/* Measure the timeouts, called from a timer ISR every TWI_TICK_MS. A
+ * request which times out is completed with TWI_TIMEOUT and the TWI module
+ * is stopped until TWI_process recovers the bus */
+void TWI_tick(void);
+/* Function called from TWI_tick when the bus needs a recovery, so the
+ * application can call TWI_process out of the ISR */
+void TWI_setRecoveryCallBack(void(*a_ptr)(void));
+/* Recover the bus after a request timed out and start the waiting requests,
+ * nothing is done if no recovery is pending. Not to be called from an ISR as
+ * the recovery takes about 100 us */
+void TWI_process(void);
+/* Clock out up to 9 SCL pulses until SDA is released, send STOP and
+ * initialize the TWI module again with the last configuration */
+void TWI_recover(void);
 
 
 #endif
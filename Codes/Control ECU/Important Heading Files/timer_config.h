@@ -0,0 +1,40 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	timer_config.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Handlers of the Control ECU bound statically to the timer
+					interrupts
+------------------------------------------------------------------------------*/
+
+#ifndef TIMER_CONFIG_H
+#define TIMER_CONFIG_H
+
+/* The ISR of a vector whose handler is named here calls it directly and its
+ * TIMERx_setCallBack is ignored. Comment the line of a vector to set its
+ * callback at run time again.
+ *
+ * ISR entry to exit of a Timer 1 or Timer 2 vector at 8 MHz, counted from
+ * the avr-gcc -Os code of the drivers compiled one file at a time (not
+ * measured on hardware):
+ *   TIMERx_setCallBack   : 87 cycles + handler (pointer loads, NULL check,
+ *                          icall and the 12 call-used registers saved)
+ *   bound here           : 78 cycles + handler (direct call), the binding
+ *                          of both ECUs
+ * Only a build with -flto, which these ECUs do not use, inlines the bound
+ * handler into the ISR: 26 + 4*n cycles + handler body for n registers
+ * saved by the handler.
+ */
+
+/* Timer 1, the time base of the software timers */
+/* #define TIMER1_CTC_HANDLER */
+#define TIMER1_OVF_HANDLER SWTIMER_tick
+/* #define TIMER1_COMPB_HANDLER */
+
+/* Timer 2, the PWM of door 0 */
+/* #define TIMER2_OVF_HANDLER */
+/* #define TIMER2_CTC_HANDLER */
+
+#endif
@@ -0,0 +1,60 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	power.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Header File for the Power Manager, it puts the MC to sleep
+					while there is no work and measures the time spent awake
+					and asleep
+------------------------------------------------------------------------------*/
+
+#ifndef POWER_H
+#define POWER_H
+
+#include "../Important Heading Files/std_types.h"
+#include "../Important Heading Files/common_macros.h"
+#include "../Important Heading Files/micro_config.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Preprocessor Macros                                    *
+ ------------------------------------------------------------------------------*/
+#define NULL_PTR (void *) 0
+/* SM2 SM1 SM0 bits of MCUCR */
+#define NUM_TO_CLEAR_SLEEP_BITS 0x0F
+
+/* -----------------------------------------------------------------------------
+ *                         Types Declaration                                   *
+ ------------------------------------------------------------------------------*/
+/*
+ * POWER_IDLE       : CPU clock stopped, UART, TWI and timers keep running
+ * POWER_POWER_SAVE : only Timer 2 runs and only if it is clocked from the
+ *                    TOSC crystal (AS2 = 1), the UART cannot wake the MC
+ */
+typedef enum
+{
+	POWER_IDLE=0x00,POWER_POWER_SAVE=0x30
+}Power_Mode;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes                                   *
+ ------------------------------------------------------------------------------*/
+/*
+ * Sleep until the next interrupt. It must be called with the I-bit cleared
+ * after checking that there is no work, so an interrupt which brings work
+ * cannot come between the check and the sleep. It returns with the I-bit set.
+ */
+void POWER_sleep(Power_Mode mode);
+/* Called from a periodic timer ISR, counts the ticks since boot */
+void POWER_tick(void);
+/*
+ * Set the clock in us read around the sleep instruction to measure the time
+ * asleep and the period of POWER_tick in us. Without a clock the whole time
+ * is counted awake.
+ */
+void POWER_setClock(uint32(*a_clock)(void),uint32 tickUs);
+/* Ticks spent awake and asleep since boot */
+void POWER_getStats(uint32 *awakeTicks,uint32 *asleepTicks);
+
+#endif
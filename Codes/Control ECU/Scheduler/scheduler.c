@@ -0,0 +1,68 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	scheduler.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Scheduler, an event queue fed by the ISRs and drained by
+					the main loop. Every event is handled to completion
+					before the next one, so the handlers must not wait.
+------------------------------------------------------------------------------*/
+
+#include "scheduler.h"
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+/* Event queue: written by SCHED_post (head), read by SCHED_get (tail) */
+static volatile Sched_EventType g_queue[SCHED_QUEUE_SIZE];
+static volatile uint8 g_queueHead=0;
+static volatile uint8 g_queueTail=0;
+static uint8 g_maxDepth=0;
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+bool SCHED_post(uint8 type,uint8 arg)
+{
+	uint8 sreg = SREG;
+	uint8 next;
+	uint8 depth;
+	/* Events are posted from the main loop and from several ISRs */
+	CLEAR_BIT(SREG,7);
+	next = (g_queueHead+1) & SCHED_QUEUE_MASK;
+	if(next == g_queueTail)
+	{
+		SREG = sreg;
+		return FALSE;
+	}
+	g_queue[g_queueHead].type = type;
+	g_queue[g_queueHead].arg = arg;
+	g_queueHead = next;
+	depth = (g_queueHead-g_queueTail) & SCHED_QUEUE_MASK;
+	if(depth > g_maxDepth)
+	{
+		g_maxDepth = depth;
+	}
+	SREG = sreg;
+	return TRUE;
+}
+
+bool SCHED_get(Sched_EventType *event)
+{
+	if(g_queueTail == g_queueHead)
+	{
+		return FALSE;
+	}
+	event->type = g_queue[g_queueTail].type;
+	event->arg = g_queue[g_queueTail].arg;
+	/* The tail is only written here, the ISRs only read it */
+	g_queueTail = (g_queueTail+1) & SCHED_QUEUE_MASK;
+	return TRUE;
+}
+
+uint8 SCHED_getMaxDepth(void)
+{
+	return g_maxDepth;
+}
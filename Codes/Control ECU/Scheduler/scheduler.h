@@ -0,0 +1,50 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	scheduler.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Header File for the Scheduler, an event queue fed by the
+					ISRs and drained by a run-to-completion loop
+------------------------------------------------------------------------------*/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "../Important Heading Files/std_types.h"
+#include "../Important Heading Files/common_macros.h"
+#include "../Important Heading Files/micro_config.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Preprocessor Macros                                    *
+ ------------------------------------------------------------------------------*/
+/* Number of events waiting to be handled, must be a power of two */
+#define SCHED_QUEUE_SIZE 16
+#define SCHED_QUEUE_MASK (SCHED_QUEUE_SIZE-1)
+
+#if ((SCHED_QUEUE_SIZE & SCHED_QUEUE_MASK) != 0) || (SCHED_QUEUE_SIZE > 256)
+#error "SCHED_QUEUE_SIZE must be a power of two not more than 256"
+#endif
+
+/* -----------------------------------------------------------------------------
+ *                         Types Declaration                                   *
+ ------------------------------------------------------------------------------*/
+/* The event types are defined by the application */
+typedef struct
+{
+	uint8 type;
+	uint8 arg;
+}Sched_EventType;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes                                   *
+ ------------------------------------------------------------------------------*/
+/* Queue an event, it can be called from ISRs. FALSE if the queue is full */
+bool SCHED_post(uint8 type,uint8 arg);
+/* Take the oldest event, FALSE if there is no event */
+bool SCHED_get(Sched_EventType *event);
+/* Most events ever waiting together, to check SCHED_QUEUE_SIZE */
+uint8 SCHED_getMaxDepth(void);
+
+#endif
@@ -0,0 +1,17 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	interrupt.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Interrupts for the Linux build of the drivers, an ISR is
+					a normal function called by the simulator.
+------------------------------------------------------------------------------*/
+
+#ifndef SIM_AVR_INTERRUPT_H
+#define SIM_AVR_INTERRUPT_H
+
+#define ISR(vector) void vector(void)
+
+#endif
@@ -0,0 +1,45 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	io.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	ATmega16 registers for the Linux build of the drivers. The
+					TWI registers are read and written through the 24C16
+					model in twi_sim.c, the other registers are plain
+					variables.
+------------------------------------------------------------------------------*/
+
+#ifndef SIM_AVR_IO_H
+#define SIM_AVR_IO_H
+
+/* -----------------------------------------------------------------------------
+ *                         Registers                                           *
+ ------------------------------------------------------------------------------*/
+extern volatile unsigned char SIM_TWCR,SIM_TWDR,SIM_TWSR,SIM_TWBR,SIM_TWAR;
+extern volatile unsigned char SREG,PORTC,DDRC,PINC;
+/* Every TWI register access runs the bus model first, so a TWCR write is
+ * carried out before the next access sees the result */
+volatile unsigned char *SIM_twiRegister(volatile unsigned char *reg);
+
+#define TWCR (*SIM_twiRegister(&SIM_TWCR))
+#define TWDR (*SIM_twiRegister(&SIM_TWDR))
+#define TWSR (*SIM_twiRegister(&SIM_TWSR))
+#define TWBR (*SIM_twiRegister(&SIM_TWBR))
+#define TWAR (*SIM_twiRegister(&SIM_TWAR))
+
+/* TWCR bits */
+#define TWIE  0
+#define TWEN  2
+#define TWWC  3
+#define TWSTO 4
+#define TWSTA 5
+#define TWEA  6
+#define TWINT 7
+
+/* PORTC bits */
+#define PC0 0
+#define PC1 1
+
+#endif
@@ -0,0 +1,141 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	eeprom_bench.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Storage benchmark which runs the I2C and External EEPROM
+					drivers on the TWI and 24C16 simulator and reports the
+					bytes, the transactions and the simulated time of every
+					EEPROM call. It checks the data read back too.
+
+					Build and run from the Control ECU folder:
+					gcc -DTRACE_DISABLE -ISimulation \
+						-o eeprom_bench \
+						Simulation/eeprom_bench.c Simulation/twi_sim.c \
+						I2C/i2c.c "External EEPROM/external_eeprom.c"
+					./eeprom_bench
+------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include "twi_sim.h"
+#include "../External EEPROM/external_eeprom.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes(Private)                          *
+ ------------------------------------------------------------------------------*/
+/* Function responsible for running the simulator until the EEPROM call ends
+ * and printing its cost */
+static uint8 BENCH_finish(const char *name,uint16 length,float64 start);
+static uint8 BENCH_write(uint16 address,uint16 length);
+static uint8 BENCH_read(uint16 address,uint16 length);
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+static uint8 g_data[256];
+static uint8 g_readBack[256];
+static volatile uint8 g_result;
+static uint8 g_failures=0;
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+static void BENCH_done(uint8 result)
+{
+	g_result = result;
+}
+
+int main(void)
+{
+	uint16 i;
+	for(i = 0; i < sizeof(g_data); i++)
+	{
+		g_data[i] = (uint8)(i*7+3);
+	}
+	SIM_reset();
+	EEPROM_init();
+
+	printf("%-28s %6s %6s %6s %6s %10s %10s\n","call","length","bytes",\
+			"trans","nacks","bus us","total us");
+	/* Every write is followed by a read of the same bytes, the read waits
+	 * for the write cycle with ACK polling */
+	BENCH_write(0x0000,1);
+	BENCH_read(0x0000,1);
+	BENCH_write(0x0010,16);
+	BENCH_read(0x0010,16);
+	BENCH_write(0x0028,16);
+	BENCH_read(0x0028,16);
+	BENCH_write(0x0100,64);
+	BENCH_read(0x0100,64);
+	BENCH_write(0x0200,256);
+	BENCH_read(0x0200,256);
+	/* A read after the write cycle has ended */
+	SIM_delayUs(SIM_EEPROM_TWR_US);
+	BENCH_read(0x0200,256);
+
+	if(g_failures != 0)
+	{
+		printf("%u calls failed\n",g_failures);
+		return 1;
+	}
+	return 0;
+}
+
+static uint8 BENCH_write(uint16 address,uint16 length)
+{
+	float64 start = SIM_now();
+	SIM_clearStats();
+	if(EEPROM_writeBlockAsync(address,g_data,length,BENCH_done) != SUCCESS)
+	{
+		g_failures++;
+		return ERROR;
+	}
+	return BENCH_finish("EEPROM_writeBlock",length,start);
+}
+
+static uint8 BENCH_read(uint16 address,uint16 length)
+{
+	float64 start = SIM_now();
+	SIM_clearStats();
+	memset(g_readBack,0,sizeof(g_readBack));
+	if(EEPROM_readBlockAsync(address,g_readBack,length,BENCH_done) != SUCCESS)
+	{
+		g_failures++;
+		return ERROR;
+	}
+	if(BENCH_finish("EEPROM_readBlock",length,start) != SUCCESS)
+	{
+		return ERROR;
+	}
+	if(memcmp(g_readBack,g_data,length) != 0)
+	{
+		printf("  data mismatch at 0x%04X\n",address);
+		g_failures++;
+		return ERROR;
+	}
+	return SUCCESS;
+}
+
+static uint8 BENCH_finish(const char *name,uint16 length,float64 start)
+{
+	Sim_StatsType stats;
+	while(EEPROM_isBusy())
+	{
+		SIM_step();
+	}
+	/* Send the STOP left by the last request */
+	SIM_step();
+	SIM_getStats(&stats);
+	printf("%-28s %6u %6lu %6lu %6lu %10.1f %10.1f\n",name,length,\
+			stats.bytes,stats.transactions,stats.nacks,stats.busUs,\
+			SIM_now()-start);
+	if(g_result != SUCCESS)
+	{
+		printf("  failed with %u\n",g_result);
+		g_failures++;
+	}
+	return g_result;
+}
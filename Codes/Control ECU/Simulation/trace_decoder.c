@@ -0,0 +1,153 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	trace_decoder.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	PC decoder of the trace sent by Control ECU. It reads the
+					raw bytes captured from the UART TX line of Control ECU,
+					finds the FRAME_TRACE frames with a valid CRC and writes
+					their records as a Chrome trace_event JSON timeline to be
+					opened in chrome://tracing or ui.perfetto.dev.
+
+					Build and run from the Control ECU folder:
+					gcc -ISimulation -o trace_decoder Simulation/trace_decoder.c \
+						"Frame Protocol/frame_crc.c"
+					./trace_decoder capture.bin > trace.json
+------------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include "../Frame Protocol/frame.h"
+#include "../Trace/trace.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes(Private)                          *
+ ------------------------------------------------------------------------------*/
+/* Function responsible for writing the records of one FRAME_TRACE payload */
+static void DECODER_frame(const uint8 *payload,uint8 length);
+static const char *DECODER_name(uint8 id);
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+static uint32 g_records=0;
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+int main(int argc,char *argv[]){
+	FILE *capture;
+	uint8 frame[FRAME_OVERHEAD+FRAME_MAX_PAYLOAD];
+	uint8 crc;
+	uint16 n=0;
+	uint32 frames=0,badFrames=0;
+	int data;
+	if(argc!=2){
+		fprintf(stderr,"Usage: %s capture.bin > trace.json\n",argv[0]);
+		return 1;
+	}
+	capture=fopen(argv[1],"rb");
+	if(capture==NULL){
+		perror(argv[1]);
+		return 1;
+	}
+	printf("{\"traceEvents\":[\n");
+	while((data=fgetc(capture))!=EOF){
+		/* | SYNC | ADDRESS | TYPE | LENGTH | PAYLOAD | CRC-8 | */
+		if(n==0 && data!=FRAME_SYNC){
+			continue;
+		}
+		frame[n++]=(uint8)data;
+		if(n==4 && frame[3]>FRAME_MAX_PAYLOAD){
+			/* Not a frame, look for the next SYNC after this one */
+			badFrames++;
+			fseek(capture,-3,SEEK_CUR);
+			n=0;
+			continue;
+		}
+		if(n<4 || n<(uint16)(frame[3]+5)){
+			continue;
+		}
+		crc=FRAME_CRC_INITIAL;
+		for(n=1;n<(uint16)(frame[3]+4);n++){
+			crc=FRAME_crc8(crc,frame[n]);
+		}
+		if(crc!=frame[n]){
+			/* Resynchronize on the byte after this SYNC */
+			badFrames++;
+			if(fseek(capture,-(long)frame[3]-4,SEEK_CUR)!=0){
+				break;
+			}
+		}
+		else if(frame[2]==FRAME_TRACE){
+			frames++;
+			DECODER_frame(&frame[4],frame[3]);
+		}
+		n=0;
+	}
+	printf("\n]}\n");
+	fclose(capture);
+	fprintf(stderr,"%lu trace frames, %lu records, %lu bad frames\n",\
+			(unsigned long)frames,(unsigned long)g_records,\
+			(unsigned long)badFrames);
+	return 0;
+}
+
+static void DECODER_frame(const uint8 *payload,uint8 length){
+	Swtimer_TimeType time;
+	float64 us;
+	uint8 id,arg,i;
+	char phase;
+	for(;length>=TRACE_RECORD_SIZE;length-=TRACE_RECORD_SIZE){
+		time.ticks=0;
+		for(i=0;i<4;i++){
+			time.ticks|=((uint32)payload[i])<<(8*i);
+		}
+		time.periods=payload[4];
+		time.counts=(uint16)(payload[5]|(payload[6]<<8));
+		id=payload[7];
+		arg=payload[8];
+		payload+=TRACE_RECORD_SIZE;
+		/*SWTIMER_TIME_US in floating point, it does not wrap after 71
+		 *minutes like SWTIMER_nowUs*/
+		us=(float64)time.ticks*(SWTIMER_TICK_MS*1000.0)+\
+				(float64)time.periods*SWTIMER_PWM_US+\
+				(float64)time.counts/SWTIMER_COUNTS_PER_US;
+		if(id & TRACE_BEGIN_FLAG){
+			phase='B';
+		}
+		else if(id & TRACE_END_FLAG){
+			phase='E';
+		}
+		else{
+			phase='i';
+		}
+		printf("%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.0f,\"pid\":1,"\
+				"\"tid\":1,%s\"args\":{\"arg\":%u}}",\
+				(g_records==0) ? "" : ",\n",DECODER_name(id & TRACE_ID_MASK),\
+				phase,us,(phase=='i') ? "\"s\":\"t\"," : "",arg);
+		g_records++;
+	}
+}
+
+static const char *DECODER_name(uint8 id){
+	switch(id){
+	case TRACE_EVENT:
+		return "event";
+	case TRACE_SLEEP:
+		return "sleep";
+	case TRACE_EEPROM_WRITE:
+		return "EEPROM_writeBlock";
+	case TRACE_EEPROM_READ:
+		return "EEPROM_readBlock";
+	case TRACE_MATCHING_CHECK:
+		return "matchingCheck";
+	case TRACE_FRAME_SEND:
+		return "sendStatus";
+	case TRACE_DOOR:
+		return "door";
+	default:
+		return "unknown";
+	}
+}
@@ -0,0 +1,286 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	twi_sim.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	TWI and 24C16 EEPROM Simulator. The TWI module of the
+					ATmega16 is modelled at the register level (TWCR, TWDR,
+					TWSR, TWBR) and drives a 24C16 model with its page
+					roll-over, its tWR write cycle during which the device
+					address is not acknowledged and the bus time at the SCL
+					frequency set by TWBR and the prescaler.
+------------------------------------------------------------------------------*/
+
+#include <string.h>
+#include "../Important Heading Files/micro_config.h"
+#include "twi_sim.h"
+
+/* ----------------------------------------------------------------------------
+ *                      Preprocessor Macros                                   *
+  ----------------------------------------------------------------------------*/
+/* Bit 1 of TWCR is reserved and always written 0 by the driver, the model
+ * sets it once it has carried out a write so the next one can be told
+ * apart from the value left by the hardware */
+#define SIM_TWCR_DONE 0x02
+#define SIM_STATUS_MASK 0xF8
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+volatile uint8 SIM_TWCR,SIM_TWDR,SIM_TWSR,SIM_TWBR,SIM_TWAR;
+volatile uint8 SREG,PORTC,DDRC,PINC=0xFF;
+
+static uint8 g_memory[SIM_EEPROM_SIZE];
+/* Page latch of the running write, written to the memory by the STOP */
+static uint8 g_latch[SIM_EEPROM_PAGE_SIZE];
+static uint8 g_latched[SIM_EEPROM_PAGE_SIZE];
+static uint16 g_address;
+static bool g_addressed;
+static bool g_wordAddressSent;
+static bool g_reading;
+/* The bus is owned between START and STOP */
+static bool g_busOwned;
+static float64 g_now;
+static float64 g_busyUntil;
+static Sim_StatsType g_stats;
+/* The TWI model is running, register accesses made by it skip the sync */
+static bool g_inModel=FALSE;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes(Private)                          *
+ ------------------------------------------------------------------------------*/
+/* Function responsible for carrying out a TWCR write */
+static void SIM_sync(void);
+/* Function responsible for one SCL period at the current TWBR and TWPS */
+static float64 SIM_bitUs(void);
+static void SIM_start(void);
+static void SIM_stop(void);
+static void SIM_transfer(uint8 twcr);
+static void SIM_setStatus(uint8 status);
+static void SIM_bus(float64 us);
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+volatile uint8 *SIM_twiRegister(volatile uint8 *reg)
+{
+	if(!g_inModel)
+	{
+		SIM_sync();
+	}
+	return reg;
+}
+
+void SIM_reset(void)
+{
+	memset(g_memory,0xFF,sizeof(g_memory));
+	memset(g_latched,0,sizeof(g_latched));
+	SIM_TWCR = SIM_TWCR_DONE;
+	SIM_TWDR = 0xFF;
+	SIM_TWSR = SIM_STATUS_MASK;
+	SIM_TWBR = 0;
+	SIM_TWAR = 0;
+	g_addressed = FALSE;
+	g_busOwned = FALSE;
+	g_now = 0;
+	g_busyUntil = 0;
+	SIM_clearStats();
+}
+
+void SIM_step(void)
+{
+	SIM_sync();
+	if((SIM_TWCR & (1<<TWINT)) && (SIM_TWCR & (1<<TWIE)) &&\
+			(SIM_TWCR & (1<<TWEN)))
+	{
+		TWI_vect();
+		SIM_sync();
+	}
+}
+
+float64 SIM_now(void)
+{
+	return g_now;
+}
+
+void SIM_getStats(Sim_StatsType *stats)
+{
+	*stats = g_stats;
+}
+
+void SIM_clearStats(void)
+{
+	memset(&g_stats,0,sizeof(g_stats));
+}
+
+uint8 *SIM_eeprom(void)
+{
+	return g_memory;
+}
+
+void SIM_delayUs(float64 us)
+{
+	g_now += us;
+}
+
+static void SIM_sync(void)
+{
+	uint8 twcr = SIM_TWCR;
+	if(twcr & SIM_TWCR_DONE)
+	{
+		return;
+	}
+	g_inModel = TRUE;
+	/* Writing TWINT clears the flag and starts the operation */
+	if((twcr & (1<<TWEN)) && (twcr & (1<<TWINT)))
+	{
+		twcr &= ~(1<<TWINT);
+		if(twcr & (1<<TWSTO))
+		{
+			SIM_stop();
+			twcr &= ~(1<<TWSTO);
+			if(twcr & (1<<TWSTA))
+			{
+				SIM_start();
+				twcr |= (1<<TWINT);
+			}
+		}
+		else if(twcr & (1<<TWSTA))
+		{
+			SIM_start();
+			twcr |= (1<<TWINT);
+		}
+		else if(g_busOwned)
+		{
+			SIM_transfer(twcr);
+			twcr |= (1<<TWINT);
+		}
+	}
+	else if(!(twcr & (1<<TWEN)))
+	{
+		/* Disabling the module releases the bus */
+		g_busOwned = FALSE;
+		g_addressed = FALSE;
+	}
+	SIM_TWCR = twcr | SIM_TWCR_DONE;
+	g_inModel = FALSE;
+}
+
+static float64 SIM_bitUs(void)
+{
+	uint8 twps = SIM_TWSR & 0x03;
+	return (16.0+2.0*SIM_TWBR*(1<<(2*twps)))*1000000.0/F_CPU;
+}
+
+static void SIM_start(void)
+{
+	if(g_busOwned)
+	{
+		SIM_setStatus(0x10);
+	}
+	else
+	{
+		g_stats.transactions++;
+		SIM_setStatus(0x08);
+	}
+	SIM_bus(SIM_bitUs());
+	g_busOwned = TRUE;
+	g_addressed = FALSE;
+}
+
+static void SIM_stop(void)
+{
+	uint8 i;
+	SIM_bus(SIM_bitUs());
+	/* A STOP after written data starts the internal write cycle */
+	if(g_addressed && !g_reading && g_wordAddressSent)
+	{
+		for(i = 0; i < SIM_EEPROM_PAGE_SIZE; i++)
+		{
+			if(g_latched[i])
+			{
+				g_memory[(g_address & ~(SIM_EEPROM_PAGE_SIZE-1)) | i] =\
+						g_latch[i];
+				g_latched[i] = FALSE;
+			}
+		}
+		g_busyUntil = g_now + SIM_EEPROM_TWR_US;
+		g_stats.writeCycles++;
+	}
+	g_busOwned = FALSE;
+	g_addressed = FALSE;
+	SIM_setStatus(SIM_STATUS_MASK);
+}
+
+static void SIM_transfer(uint8 twcr)
+{
+	uint8 status = SIM_TWSR & SIM_STATUS_MASK;
+	uint8 data = SIM_TWDR;
+	uint8 i;
+	SIM_bus(9*SIM_bitUs());
+	g_stats.bytes++;
+	if((status == 0x08) || (status == 0x10))
+	{
+		/* Address byte, the device answers 1010 A10 A9 A8 R/W unless it is
+		 * in its write cycle */
+		g_reading = data & 1;
+		if(((data & 0xF0) != 0xA0) || (g_now < g_busyUntil))
+		{
+			g_stats.nacks++;
+			SIM_setStatus(g_reading ? 0x48 : 0x20);
+			return;
+		}
+		g_address = (g_address & 0x00FF) | ((uint16)(data & 0x0E) << 7);
+		g_addressed = TRUE;
+		if(!g_reading)
+		{
+			g_wordAddressSent = FALSE;
+			for(i = 0; i < SIM_EEPROM_PAGE_SIZE; i++)
+			{
+				g_latched[i] = FALSE;
+			}
+		}
+		SIM_setStatus(g_reading ? 0x40 : 0x18);
+	}
+	else if(g_addressed && g_reading)
+	{
+		/* The address counter rolls over the whole memory when reading */
+		SIM_TWDR = g_memory[g_address];
+		g_address = (g_address+1) & (SIM_EEPROM_SIZE-1);
+		SIM_setStatus((twcr & (1<<TWEA)) ? 0x50 : 0x58);
+	}
+	else if(g_addressed)
+	{
+		if(!g_wordAddressSent)
+		{
+			g_address = (g_address & 0x0700) | data;
+			g_wordAddressSent = TRUE;
+		}
+		else
+		{
+			/* The address counter rolls over inside the page when writing */
+			g_latch[g_address & (SIM_EEPROM_PAGE_SIZE-1)] = data;
+			g_latched[g_address & (SIM_EEPROM_PAGE_SIZE-1)] = TRUE;
+			g_address = (g_address & ~(SIM_EEPROM_PAGE_SIZE-1)) |\
+					((g_address+1) & (SIM_EEPROM_PAGE_SIZE-1));
+		}
+		SIM_setStatus(0x28);
+	}
+	else
+	{
+		SIM_setStatus(0x30);
+	}
+}
+
+static void SIM_setStatus(uint8 status)
+{
+	SIM_TWSR = (SIM_TWSR & 0x03) | status;
+}
+
+static void SIM_bus(float64 us)
+{
+	g_now += us;
+	g_stats.busUs += us;
+}
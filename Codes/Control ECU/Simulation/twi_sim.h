@@ -0,0 +1,58 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	twi_sim.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Header File for the TWI and 24C16 EEPROM Simulator which
+					runs the I2C and External EEPROM drivers on Linux
+------------------------------------------------------------------------------*/
+
+#ifndef TWI_SIM_H
+#define TWI_SIM_H
+
+#include "../Important Heading Files/std_types.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Preprocessor Macros                                   *
+  ----------------------------------------------------------------------------*/
+/* 24C16: 2 KB in 8 blocks of 256 bytes, 16-byte pages */
+#define SIM_EEPROM_SIZE 2048
+#define SIM_EEPROM_PAGE_SIZE 16
+/* Internal write cycle started by the STOP of a write (tWR max) */
+#define SIM_EEPROM_TWR_US 5000.0
+
+/* -----------------------------------------------------------------------------
+ *                         Types Declaration                                   *
+ ------------------------------------------------------------------------------*/
+typedef struct
+{
+	uint32 bytes;         /* bytes on the bus, addresses included */
+	uint32 transactions;  /* START conditions, repeated STARTs excluded */
+	uint32 nacks;         /* addresses not acknowledged (ACK polling) */
+	uint32 writeCycles;   /* internal write cycles of the EEPROM */
+	float64 busUs;        /* time the bus was driven */
+}Sim_StatsType;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes                                   *
+ ------------------------------------------------------------------------------*/
+/* Erase the EEPROM (0xFF), clear the registers, the time and the stats */
+void SIM_reset(void);
+/* Carry out a pending TWCR write and call TWI_vect if TWINT and TWIE are
+ * set, the main loop of the simulated MCU */
+void SIM_step(void);
+/* Simulated time since SIM_reset in microseconds */
+float64 SIM_now(void);
+/* Move the simulated time forward, used by _delay_us too */
+void SIM_delayUs(float64 us);
+void SIM_getStats(Sim_StatsType *stats);
+void SIM_clearStats(void);
+/* Direct access to the EEPROM array to check the written data */
+uint8 *SIM_eeprom(void);
+
+/* TWI interrupt of the I2C driver */
+void TWI_vect(void);
+
+#endif
@@ -0,0 +1,20 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	delay.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Busy-wait delays for the Linux build of the drivers, they
+					move the simulated time forward.
+------------------------------------------------------------------------------*/
+
+#ifndef SIM_UTIL_DELAY_H
+#define SIM_UTIL_DELAY_H
+
+void SIM_delayUs(double us);
+
+#define _delay_us(us) SIM_delayUs(us)
+#define _delay_ms(ms) SIM_delayUs((ms)*1000.0)
+
+#endif
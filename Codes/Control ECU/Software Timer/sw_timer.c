@@ -0,0 +1,203 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	sw_timer.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Software Timers on a hashed timer wheel driven by the
+					Timer 1 overflow interrupt
+------------------------------------------------------------------------------*/
+
+#include "sw_timer.h"
+#include "../Timer 1/timer1.h"
+#include "../Important Heading Files/timer_config.h"
+
+#if (SWTIMER_TICK_COUNTS > 65536) || (SWTIMER_COUNTS_PER_US == 0)
+#error "SWTIMER_PRESCALER does not fit SWTIMER_TICK_MS or 1 us"
+#endif
+#if ((SWTIMER_TICK_COUNTS % SWTIMER_PWM_PERIODS) != 0) ||\
+	(SWTIMER_TICK_COUNTS/SWTIMER_PWM_PERIODS > 65536) ||\
+	((SWTIMER_PWM_US*SWTIMER_COUNTS_PER_US) != SWTIMER_PWM_TOP+1)
+#error "SWTIMER_PWM_PERIODS does not divide the tick in whole microseconds"
+#endif
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+/* Each slot is a doubly linked list of the timers which expire at a tick
+ * equal to the slot modulo SWTIMER_WHEEL_SIZE */
+static Swtimer_Type *g_wheel[SWTIMER_WHEEL_SIZE];
+static volatile uint32 g_ticks=0;
+/* PWM periods since the last tick */
+static volatile uint8 g_periods=0;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes(Private)                          *
+ ------------------------------------------------------------------------------*/
+static void SWTIMER_insert(Swtimer_Type *timer);
+static void SWTIMER_remove(Swtimer_Type *timer);
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+void SWTIMER_init(void)
+{
+	Timer1_ConfigType period;
+	period.mode=TIMER1_FAST_PWM_ICR1;
+	period.clock=TIMER1_F_CPU_8;
+	period.initialValue=0;
+	period.oc1AMode=OC1_A_DISCONNECT;
+	period.oc1BMode=OC1_B_DISCONNECT;
+	period.top=SWTIMER_PWM_TOP;
+	period.dutyCycleA=0;
+	period.dutyCycleB=0;
+#ifndef TIMER1_OVF_HANDLER
+	TIMER1_setCallBack(SWTIMER_tick,TIMER1_OVF);
+#endif
+	TIMER1_init(&period);
+}
+
+void SWTIMER_start(Swtimer_Type *timer,uint32 ticks,uint32 period,\
+		void (*a_ptr)(Swtimer_Type *timer))
+{
+	uint8 sreg = SREG;
+	CLEAR_BIT(SREG,7);
+	if(timer->state == SWTIMER_ARMED)
+	{
+		SWTIMER_remove(timer);
+	}
+	if(ticks == 0)
+	{
+		ticks = 1;
+	}
+	timer->expiry = g_ticks + ticks;
+	timer->period = period;
+	timer->callBack = a_ptr;
+	SWTIMER_insert(timer);
+	SREG = sreg;
+}
+
+void SWTIMER_cancel(Swtimer_Type *timer)
+{
+	uint8 sreg = SREG;
+	CLEAR_BIT(SREG,7);
+	if(timer->state == SWTIMER_ARMED)
+	{
+		SWTIMER_remove(timer);
+	}
+	SREG = sreg;
+}
+
+bool SWTIMER_isArmed(const Swtimer_Type *timer)
+{
+	return timer->state == SWTIMER_ARMED;
+}
+
+uint32 SWTIMER_getTicks(void)
+{
+	uint32 ticks;
+	uint8 sreg = SREG;
+	/* The 32-bit variable is read in 4 instructions */
+	CLEAR_BIT(SREG,7);
+	ticks = g_ticks;
+	SREG = sreg;
+	return ticks;
+}
+
+void SWTIMER_now(Swtimer_TimeType *time)
+{
+	uint8 sreg = SREG;
+	/* The ticks and the 16-bit TCNT1 (read through the TEMP register) are
+	 * read together with the interrupts disabled */
+	CLEAR_BIT(SREG,7);
+	time->ticks = g_ticks;
+	time->periods = g_periods;
+	time->counts = TCNT1;
+	if(BIT_IS_SET(TIFR,TOV1))
+	{
+		/* TCNT1 passed TOP and the ISR did not count the period yet, read it
+		 * again as it may have been read before TOP */
+		time->periods++;
+		time->counts = TCNT1;
+	}
+	SREG = sreg;
+}
+
+uint32 SWTIMER_nowUs(void)
+{
+	Swtimer_TimeType time;
+	SWTIMER_now(&time);
+	return SWTIMER_TIME_US(time);
+}
+
+uint32 SWTIMER_elapsedUs(uint32 start)
+{
+	return SWTIMER_nowUs() - start;
+}
+
+void SWTIMER_tick(void)
+{
+	Swtimer_Type *timer;
+	uint32 now;
+	if(++g_periods < SWTIMER_PWM_PERIODS)
+	{
+		return;
+	}
+	g_periods = 0;
+	now = g_ticks + 1;
+	g_ticks = now;
+	/* The slot is searched again after every callback as the callback can
+	 * start or cancel any timer. Timers of later turns of the wheel stay */
+	do
+	{
+		timer = g_wheel[(uint8)now & SWTIMER_WHEEL_MASK];
+		while((timer != NULL_PTR) && (timer->expiry != now))
+		{
+			timer = timer->next;
+		}
+		if(timer != NULL_PTR)
+		{
+			SWTIMER_remove(timer);
+			if(timer->period != 0)
+			{
+				timer->expiry = now + timer->period;
+				SWTIMER_insert(timer);
+			}
+			if(timer->callBack != NULL_PTR)
+			{
+				(*timer->callBack)(timer);
+			}
+		}
+	}while(timer != NULL_PTR);
+}
+
+static void SWTIMER_insert(Swtimer_Type *timer)
+{
+	Swtimer_Type **slot = &g_wheel[(uint8)timer->expiry & SWTIMER_WHEEL_MASK];
+	timer->prev = NULL_PTR;
+	timer->next = *slot;
+	if(*slot != NULL_PTR)
+	{
+		(*slot)->prev = timer;
+	}
+	*slot = timer;
+	timer->state = SWTIMER_ARMED;
+}
+
+static void SWTIMER_remove(Swtimer_Type *timer)
+{
+	if(timer->prev != NULL_PTR)
+	{
+		timer->prev->next = timer->next;
+	}
+	else
+	{
+		g_wheel[(uint8)timer->expiry & SWTIMER_WHEEL_MASK] = timer->next;
+	}
+	if(timer->next != NULL_PTR)
+	{
+		timer->next->prev = timer->prev;
+	}
+	timer->state = SWTIMER_IDLE;
+}
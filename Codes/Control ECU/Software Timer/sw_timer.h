@@ -0,0 +1,107 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	sw_timer.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Header File for the Software Timers, one-shot and periodic
+					timers multiplexed on the Timer 1 tick by a hashed
+					timer wheel
+------------------------------------------------------------------------------*/
+
+#ifndef SW_TIMER_H
+#define SW_TIMER_H
+
+#include "../Important Heading Files/std_types.h"
+#include "../Important Heading Files/common_macros.h"
+#include "../Important Heading Files/micro_config.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Preprocessor Macros                                    *
+ ------------------------------------------------------------------------------*/
+/* Period of the software timers */
+#define SWTIMER_TICK_MS 10
+#define SWTIMER_TICKS_PER_SECOND (1000/SWTIMER_TICK_MS)
+/* Timer 1 prescaler, one count is 1 us at 8 MHz and a tick of 10 ms is
+ * 10000 counts */
+#define SWTIMER_PRESCALER 8
+#define SWTIMER_TICK_COUNTS ((F_CPU/SWTIMER_PRESCALER/1000)*SWTIMER_TICK_MS)
+#define SWTIMER_COUNTS_PER_US (F_CPU/SWTIMER_PRESCALER/1000000)
+/* Timer 1 runs in fast PWM mode with TOP in ICR1 so OC1A and OC1B can drive
+ * motors, a tick is SWTIMER_PWM_PERIODS overflows (1 kHz PWM at 8 MHz).
+ * The duty cycle of OC1A and OC1B is 0 to SWTIMER_PWM_TOP */
+#define SWTIMER_PWM_PERIODS 10
+#define SWTIMER_PWM_TOP (SWTIMER_TICK_COUNTS/SWTIMER_PWM_PERIODS-1)
+#define SWTIMER_PWM_US (SWTIMER_TICK_MS*1000UL/SWTIMER_PWM_PERIODS)
+/* Convert a time to ticks, rounded up so a timer never expires early */
+#define SWTIMER_MS(ms) (((ms)+SWTIMER_TICK_MS-1)/SWTIMER_TICK_MS)
+#define SWTIMER_SECONDS(s) ((s)*SWTIMER_TICKS_PER_SECOND)
+/* Microseconds of a time read by SWTIMER_now */
+#define SWTIMER_TIME_US(time) (((time).ticks*(SWTIMER_TICK_MS*1000UL))+\
+		((time).periods*SWTIMER_PWM_US)+((time).counts/SWTIMER_COUNTS_PER_US))
+/* Slots of the wheel, must be a power of two. A timer is hashed to the slot
+ * of its expiry tick, so every tick only visits the timers of one slot */
+#define SWTIMER_WHEEL_SIZE 32
+#define SWTIMER_WHEEL_MASK (SWTIMER_WHEEL_SIZE-1)
+
+/* -----------------------------------------------------------------------------
+ *                         Types Declaration                                   *
+ ------------------------------------------------------------------------------*/
+typedef enum
+{
+	SWTIMER_IDLE,SWTIMER_ARMED
+}Swtimer_State;
+
+/* Time since SWTIMER_init as read from the counters, SWTIMER_TIME_US gives
+ * its microseconds */
+typedef struct
+{
+	uint32 ticks;
+	uint16 counts;   /* TCNT1 in the PWM period */
+	uint8 periods;   /* PWM periods of the tick */
+}Swtimer_TimeType;
+
+/*
+ * A timer is owned by the caller and must stay valid while it is armed, it
+ * starts IDLE when it is a global or static variable. The callback is called
+ * from the Timer 1 ISR.
+ */
+typedef struct Swtimer
+{
+	struct Swtimer *next;
+	struct Swtimer *prev;
+	uint32 expiry;   /* tick at which the timer expires */
+	uint32 period;   /* ticks between the expiries, 0 for a one-shot timer */
+	void (*callBack)(struct Swtimer *timer);
+	volatile Swtimer_State state;
+}Swtimer_Type;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes                                   *
+ ------------------------------------------------------------------------------*/
+/* Start Timer 1 in fast PWM mode with the outputs disconnected and its
+ * overflow interrupt every 1/SWTIMER_PWM_PERIODS of a tick */
+void SWTIMER_init(void);
+/* Arm a timer to expire after ticks (at least 1) then every period ticks
+ * if period is not 0, an armed timer is started again. O(1) */
+void SWTIMER_start(Swtimer_Type *timer,uint32 ticks,uint32 period,\
+		void (*a_ptr)(Swtimer_Type *timer));
+/* Disarm a timer, nothing is done if it is not armed. O(1) */
+void SWTIMER_cancel(Swtimer_Type *timer);
+bool SWTIMER_isArmed(const Swtimer_Type *timer);
+/* Ticks since SWTIMER_init */
+uint32 SWTIMER_getTicks(void);
+/* Time since SWTIMER_init without any multiplication, for the trace points */
+void SWTIMER_now(Swtimer_TimeType *time);
+/* Microseconds since SWTIMER_init from the ticks and TCNT1, it wraps
+ * after about 71 minutes */
+uint32 SWTIMER_nowUs(void);
+/* Microseconds since a SWTIMER_nowUs value, correct across the wrap */
+uint32 SWTIMER_elapsedUs(uint32 start);
+/* Count the PWM periods, every SWTIMER_PWM_PERIODS of them advance the time
+ * and run the expired timers. The Timer 1 overflow handler bound in
+ * timer_config.h */
+void SWTIMER_tick(void);
+
+#endif
@@ -9,40 +9,71 @@
 --------------------------------------------------------------------------------*/
 
 #include "timer1.h"
+#include "../Important Heading Files/timer_config.h"
 
 /* -----------------------------------------------------------------------------
  *                           Global Variables                                  *
 -------------------------------------------------------------------------------*/
+#ifndef TIMER1_OVF_HANDLER
 static volatile void (*g_callBackPtrOvf)(void) = NULL_PTR;
+#endif
+#ifndef TIMER1_CTC_HANDLER
 static volatile void (*g_callBackPtrCompA)(void) = NULL_PTR;
+#endif
+#ifndef TIMER1_COMPB_HANDLER
 static volatile void (*g_callBackPtrCompB)(void) = NULL_PTR;
+#endif
 
+/* -----------------------------------------------------------------------------
+ *                      Statically Bound Handlers                              *
+ ------------------------------------------------------------------------------*/
+#ifdef TIMER1_OVF_HANDLER
+void TIMER1_OVF_HANDLER(void);
+#endif
+#ifdef TIMER1_CTC_HANDLER
+void TIMER1_CTC_HANDLER(void);
+#endif
+#ifdef TIMER1_COMPB_HANDLER
+void TIMER1_COMPB_HANDLER(void);
+#endif
 
 /* -----------------------------------------------------------------------------
  *                       Interrupt Service Routines                            *
  ------------------------------------------------------------------------------*/
 ISR(TIMER1_OVF_vect){
+#ifdef TIMER1_OVF_HANDLER
+	TIMER1_OVF_HANDLER();
+#else
 	if(g_callBackPtrOvf != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the edge is detected */
 		(*g_callBackPtrOvf)(); /* another method to call the function using pointer to function g_callBackPtr(); */
 	}
+#endif
 }
 
 ISR(TIMER1_COMPA_vect){
+#ifdef TIMER1_CTC_HANDLER
+	TIMER1_CTC_HANDLER();
+#else
 	if(g_callBackPtrCompA != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the edge is detected */
 		(*g_callBackPtrCompA)(); /* another method to call the function using pointer to function g_callBackPtr(); */
 	}
+#endif
 }
 
 ISR(TIMER1_COMPB_vect){
+#ifdef TIMER1_COMPB_HANDLER
+	TIMER1_COMPB_HANDLER();
+#else
 	if(g_callBackPtrCompB != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the edge is detected */
 		(*g_callBackPtrCompB)(); /* another method to call the function using pointer to function g_callBackPtr(); */
 	}
+#endif
 }
 
 /* -----------------------------------------------------------------------------
@@ -91,10 +122,11 @@ void TIMER1_init(const Timer1_ConfigType * Config_Ptr){
 		break;
 
 	case TIMER1_FAST_PWM_ICR1:
-		/*Disable All Interrupts*/
+		/*Overflow Interrupt Enable, once every PWM period at TOP*/
+		SET_BIT(TIMSK,TOIE1);
+		/*Disable Other Modes Interrupts*/
 		CLEAR_BIT(TIMSK,OCIE1A);
 		CLEAR_BIT(TIMSK,OCIE1B);
-		CLEAR_BIT(TIMSK,TOIE1);
 		/*DisableForce Output Compare*/
 		CLEAR_BIT(TCCR1A,FOC1A);
 		CLEAR_BIT(TCCR1A,FOC1B);
@@ -149,13 +181,20 @@ void TIMER1_init(const Timer1_ConfigType * Config_Ptr){
 
 void TIMER1_setCallBack(void(*a_ptr)(void),const Timer1_ModeOfOperation mode){
 	/* Save the address of the Call back function in a global variable */
+	/* Nothing is saved for a vector bound to its handler in timer_config.h */
 	switch (mode){
+#ifndef TIMER1_OVF_HANDLER
 	case TIMER1_OVF:
 		g_callBackPtrOvf = a_ptr;
 		break;
+#endif
+#ifndef TIMER1_CTC_HANDLER
 	case TIMER1_CTC:
 		g_callBackPtrCompA = a_ptr;
 		break;
+#endif
+	default:
+		break;
 	}
 }
 
@@ -177,6 +216,24 @@ void TIMER1_stopCount(void){
 	TCCR1B &= NUM_TO_CLEAR_FIRST_3_BITS;
 }
 
+void TIMER1_setOc1AMode(const Timer1_Oc1AMode a_mode){
+	TCCR1A = (TCCR1A & NUM_TO_CLEAR_LAST_2_BITS) |\
+			((a_mode & NUM_TO_CLEAR_LAST_6_BITS)<<6);
+	if(a_mode != OC1_A_DISCONNECT){
+		/*OC1A as output*/
+		DDRD |= (1<<PD5);
+	}
+}
+
+void TIMER1_setOc1BMode(const Timer1_Oc1BMode a_mode){
+	TCCR1A = (TCCR1A & NUM_TO_CLEAR_4_5TH_BITS) |\
+			((a_mode & NUM_TO_CLEAR_LAST_6_BITS)<<4);
+	if(a_mode != OC1_B_DISCONNECT){
+		/*OC1B as output*/
+		DDRD |= (1<<PD4);
+	}
+}
+
 void TIMER1_changeDutyCyle(uint16 duty,Timer1_channels channel){
 	switch (channel){
 	case OC1_A:
@@ -74,7 +74,7 @@ typedef struct
 #define NUM_TO_CLEAR_LAST_2_BITS 0x3F
 #define NUM_TO_CLEAR_4_5TH_BITS 0xCF
 #define NUM_TO_CLEAR_FIRST_3_BITS 0xF8
-#define NUM_TO_CLEAR_LAST_5_BITS 0X07
+#define NUM_TO_CLEAR_LAST_5_BITS 0x07
 
 /* -----------------------------------------------------------------------------
  *                      Functions Prototypes                                   *
@@ -85,5 +85,8 @@ void TIMER1_deInit(void);
 void TIMER1_startCount(const Timer1_Clock a_clock);
 void TIMER1_stopCount(void);
 void TIMER1_changeDutyCyle(uint16 duty,Timer1_channels channel);
+/* Connect or disconnect an output compare pin while the timer runs */
+void TIMER1_setOc1AMode(const Timer1_Oc1AMode a_mode);
+void TIMER1_setOc1BMode(const Timer1_Oc1BMode a_mode);
 
 #endif
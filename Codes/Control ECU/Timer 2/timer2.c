@@ -9,30 +9,53 @@
 --------------------------------------------------------------------------------*/
 
 #include "timer2.h"
+#include "../Important Heading Files/timer_config.h"
 
 /* -----------------------------------------------------------------------------
  *                           Global Variables                                  *
 -------------------------------------------------------------------------------*/
+#ifndef TIMER2_OVF_HANDLER
 static volatile void (*g_callBackPtrOvf)(void) = NULL_PTR;
+#endif
+#ifndef TIMER2_CTC_HANDLER
 static volatile void (*g_callBackPtrComp)(void) = NULL_PTR;
+#endif
+
+/* -----------------------------------------------------------------------------
+ *                      Statically Bound Handlers                              *
+ ------------------------------------------------------------------------------*/
+#ifdef TIMER2_OVF_HANDLER
+void TIMER2_OVF_HANDLER(void);
+#endif
+#ifdef TIMER2_CTC_HANDLER
+void TIMER2_CTC_HANDLER(void);
+#endif
 
 /* -----------------------------------------------------------------------------
  *                       Interrupt Service Routines                            *
  ------------------------------------------------------------------------------*/
 ISR(TIMER2_OVF_vect){
+#ifdef TIMER2_OVF_HANDLER
+	TIMER2_OVF_HANDLER();
+#else
 	if(g_callBackPtrOvf != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the edge is detected */
 		(*g_callBackPtrOvf)(); /* another method to call the function using pointer to function g_callBackPtr(); */
 	}
+#endif
 }
 
 ISR(TIMER2_COMP_vect){
+#ifdef TIMER2_CTC_HANDLER
+	TIMER2_CTC_HANDLER();
+#else
 	if(g_callBackPtrComp != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the edge is detected */
 		(*g_callBackPtrComp)(); /* another method to call the function using pointer to function g_callBackPtr(); */
 	}
+#endif
 }
 
 /* -----------------------------------------------------------------------------
@@ -66,6 +89,7 @@ void TIMER2_init(const Timer2_ConfigType * Config_Ptr){
 		break;
 
 	case TIMER2_FAST_PWM:
+	case TIMER2_PHASE_CORRECT_PWM:
 		/*Disable all Interrupts*/
 		CLEAR_BIT(TIMSK,OCIE2);
 		CLEAR_BIT(TIMSK,TOIE2);
@@ -102,12 +126,20 @@ void TIMER2_init(const Timer2_ConfigType * Config_Ptr){
 
 void TIMER2_setCallBack(void(*a_ptr)(void),Timer2_ModeOfOperation mode){
 	/* Save the address of the Call back function in a global variable */
+	/* Nothing is saved for a vector bound to its handler in timer_config.h */
 	switch (mode){
+#ifndef TIMER2_OVF_HANDLER
 	case TIMER2_OVF:
 		g_callBackPtrOvf = a_ptr;
 		break;
+#endif
+#ifndef TIMER2_CTC_HANDLER
 	case TIMER2_CTC:
 		g_callBackPtrComp = a_ptr;
+		break;
+#endif
+	default:
+		break;
 	}
 }
 
@@ -19,8 +19,10 @@
  ------------------------------------------------------------------------------*/
 typedef enum
 {
-	TIMER2_OVF,TIMER2_CTC=2,TIMER2_FAST_PWM=3
+	TIMER2_OVF,TIMER2_PHASE_CORRECT_PWM=1,TIMER2_CTC=2,TIMER2_FAST_PWM=3
 }Timer2_ModeOfOperation;
+/*Fast PWM runs at F_CPU/(N*256) and phase correct PWM at F_CPU/(N*510) for
+ *a prescaler N*/
 
 
 typedef enum
@@ -56,7 +58,7 @@ typedef struct
 #define NUM_TO_CLEAR_4_5TH_BITS 0xCF
 #define NUM_TO_CLEAR_LAST_6_BITS 0x03
 #define NUM_TO_CLEAR_FIRST_3_BITS 0xF8
-#define NUM_TO_CLEAR_LAST_5_BITS 0X07
+#define NUM_TO_CLEAR_LAST_5_BITS 0x07
 #define BIT6 6
 #define BIT2 2 
 #define BIT4 4
@@ -0,0 +1,69 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	trace.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Trace, events are time-stamped with the raw counters of the
+					software timers and kept in a RAM ring
+------------------------------------------------------------------------------*/
+
+#include "trace.h"
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+static Trace_RecordType g_records[TRACE_SIZE];
+/* Next record to write and number of valid records */
+static uint8 g_head=0;
+static uint8 g_count=0;
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+void TRACE_record(uint8 id,uint8 arg){
+	Swtimer_TimeType time;
+	uint8 sreg;
+	Trace_RecordType *record;
+	/*The counters are kept as they are, the multiplications of SWTIMER_nowUs
+	 *are left to the decoder*/
+	SWTIMER_now(&time);
+	sreg=SREG;
+	/*The ring is written from the main loop and from the ISRs*/
+	CLEAR_BIT(SREG,7);
+	record=&g_records[g_head];
+	g_head=(g_head+1)&TRACE_MASK;
+	if(g_count<TRACE_SIZE){
+		g_count++;
+	}
+	SREG=sreg;
+	/*The slot is reserved, it is filled with the interrupts enabled*/
+	record->time=time;
+	record->id=id;
+	record->arg=arg;
+}
+
+uint8 TRACE_count(void){
+	return g_count;
+}
+
+uint8 TRACE_pop(Trace_RecordType *record){
+	uint8 sreg=SREG;
+	uint8 found=FALSE;
+	CLEAR_BIT(SREG,7);
+	if(g_count!=0){
+		*record=g_records[(uint8)(g_head-g_count)&TRACE_MASK];
+		g_count--;
+		found=TRUE;
+	}
+	SREG=sreg;
+	return found;
+}
+
+void TRACE_clear(void){
+	uint8 sreg=SREG;
+	CLEAR_BIT(SREG,7);
+	g_count=0;
+	SREG=sreg;
+}
@@ -0,0 +1,77 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	trace.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Header File for the Trace, a RAM ring of time-stamped
+					events written by trace points in the hot paths
+------------------------------------------------------------------------------*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "../Important Heading Files/std_types.h"
+#include "../Software Timer/sw_timer.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Preprocessor Macros                                    *
+ ------------------------------------------------------------------------------*/
+/* Define TRACE_DISABLE here or in the build to compile all the trace points
+ * out, the simulator builds do it as they have no microsecond clock */
+#ifndef TRACE_DISABLE
+#define TRACE_ENABLE
+#endif
+/* Records kept in RAM, the oldest is overwritten, must be a power of two */
+#define TRACE_SIZE 32
+#define TRACE_MASK (TRACE_SIZE-1)
+/* Phase of the record in the two high bits of its id, an id without them is
+ * an instant event */
+#define TRACE_BEGIN_FLAG 0x80
+#define TRACE_END_FLAG 0x40
+#define TRACE_ID_MASK 0x3F
+/* | TICKS (4 bytes) | PERIODS | TCNT1 (2 bytes) | ID | ARG | in the
+ * FRAME_TRACE frames, LSB first. The decoder converts the time to us */
+#define TRACE_RECORD_SIZE 9
+
+#if ((TRACE_SIZE & TRACE_MASK) != 0) || (TRACE_SIZE > 256)
+#error "TRACE_SIZE must be a power of two not more than 256"
+#endif
+
+#ifdef TRACE_ENABLE
+#define TRACE_BEGIN(id,arg) TRACE_record((id)|TRACE_BEGIN_FLAG,(arg))
+#define TRACE_END(id,arg) TRACE_record((id)|TRACE_END_FLAG,(arg))
+#define TRACE_MARK(id,arg) TRACE_record((id),(arg))
+#else
+#define TRACE_BEGIN(id,arg)
+#define TRACE_END(id,arg)
+#define TRACE_MARK(id,arg)
+#endif
+
+/* -----------------------------------------------------------------------------
+ *                         Types Declaration                                   *
+ ------------------------------------------------------------------------------*/
+typedef enum{
+	TRACE_EVENT=1,TRACE_SLEEP,TRACE_EEPROM_WRITE,TRACE_EEPROM_READ,\
+	TRACE_MATCHING_CHECK,TRACE_FRAME_SEND,TRACE_DOOR
+}Trace_EventId;
+
+typedef struct{
+	Swtimer_TimeType time;  /* SWTIMER_now */
+	uint8 id;
+	uint8 arg;
+}Trace_RecordType;
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Prototypes                                   *
+ ------------------------------------------------------------------------------*/
+/* Add a record, it can be called from ISRs. Use the TRACE_ macros */
+void TRACE_record(uint8 id,uint8 arg);
+/* Number of records in the ring */
+uint8 TRACE_count(void);
+/* Take the oldest record out of the ring, returns FALSE when it is empty */
+uint8 TRACE_pop(Trace_RecordType *record);
+void TRACE_clear(void);
+
+#endif
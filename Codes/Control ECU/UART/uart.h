@@ -20,7 +20,7 @@
  ------------------------------------------------------------------------------*/
 
 typedef enum{
-	UART_5_BIT,UART_6_BIT,UART_7_BIT,UART_8_BIT
+	UART_5_BIT,UART_6_BIT,UART_7_BIT,UART_8_BIT,UART_9_BIT=7
 }Uart_DataBits;
 
 typedef enum{
@@ -31,36 +31,112 @@ typedef enum{
 	UART_1_BIT,UART_2_BIT
 }Uart_StopBits;
 
+/*------------------------- Multi-processor Bus ---------------------------------
+ * UART_POINT_TO_POINT : Normal link between two ECUs
+ * UART_BUS_MASTER     : 9-bit mode, sends an address byte (9th bit = 1) before
+ *                       the data bytes of each message
+ * UART_BUS_SLAVE      : 9-bit mode with MPCM = 1, the data bytes addressed to
+ *                       other slaves are dropped by the hardware without
+ *                       any interrupt
+ -----------------------------------------------------------------------------*/
+typedef enum{
+	UART_POINT_TO_POINT,UART_BUS_MASTER,UART_BUS_SLAVE
+}Uart_BusMode;
+
 typedef struct{
-	uint16 baudRate;
+	uint32 baudRate;
 	Uart_DataBits dataBits;
 	Uart_ParityType parityType;
 	Uart_StopBits stopBits;
+	Uart_BusMode busMode;
+	uint8 address;
 }Uart_ConfigType;
 
 /* -----------------------------------------------------------------------------
  *                      Preprocessor Macros                                    *
  ------------------------------------------------------------------------------*/
-#define POLLING_MODE
+/* Select one of POLLING_MODE or INTERRUPT_MODE */
+#define INTERRUPT_MODE
 #define NUM_TO_CLEAR_2ND_BIT 0xFB
 #define NUM_TO_CLEAR_FIRST_2_BITS_LAST_5_BITS 0x04
 #define NUM_TO_CLEAR_1ST_2ND_BITS 0xF9
 #define NUM_TO_CLEAR_LAST_6_BITS 0x03
 #define NUM_TO_CLEAR_LAST_5_BITS 0x07
 #define NUM_TO_CLEAR_4TH_5TH_BITS 0xCF
+/* UCSRA bits which keep their value when writing 1 to TXC to clear it */
+#define UART_UCSRA_WRITE_MASK ((1<<U2X)|(1<<MPCM))
+/* Address received by all the slaves on the bus */
+#define UART_BROADCAST_ADDRESS 0xFF
+
+/*------------------------- Baud Rate Calculation ------------------------------
+ * With U2X = 1 : BAUD = F_CPU/(8*(UBRR+1))
+ * UART_UBRR computes the nearest UBRR value and UART_BAUD_ERROR the error of
+ * the real baud rate in 0.1% units, both at compile time.
+ -----------------------------------------------------------------------------*/
+#define UART_UBRR(BAUD) ((((F_CPU)+(4UL*(BAUD)))/(8UL*(BAUD)))-1UL)
+#define UART_REAL_BAUD(BAUD) ((F_CPU)/(8UL*(UART_UBRR(BAUD)+1UL)))
+#define UART_BAUD_ERROR(BAUD) \
+	(((UART_REAL_BAUD(BAUD) > (BAUD)) ? (UART_REAL_BAUD(BAUD)-(BAUD)) :\
+	((BAUD)-UART_REAL_BAUD(BAUD)))*1000UL/(BAUD))
+/* Maximum accepted baud rate error 2.0% */
+#define UART_MAX_BAUD_ERROR 20UL
+#define UART_BAUD_IS_VALID(BAUD) \
+	((UART_UBRR(BAUD) <= 4095UL) && (UART_BAUD_ERROR(BAUD) <= UART_MAX_BAUD_ERROR))
+
+/* Baud rate used after reset and before the two ECUs negotiate a faster one */
+#define UART_DEFAULT_BAUD 9600UL
+#if !UART_BAUD_IS_VALID(UART_DEFAULT_BAUD)
+#error "UART_DEFAULT_BAUD has more than 2% error with this F_CPU"
+#endif
+
+#ifdef INTERRUPT_MODE
+/* Ring buffers sizes, must be a power of two and not more than 256 */
+#define UART_RX_BUFFER_SIZE 64
+#define UART_TX_BUFFER_SIZE 32
+#define UART_RX_BUFFER_MASK (UART_RX_BUFFER_SIZE-1)
+#define UART_TX_BUFFER_MASK (UART_TX_BUFFER_SIZE-1)
+
+#if ((UART_RX_BUFFER_SIZE & UART_RX_BUFFER_MASK) != 0) || (UART_RX_BUFFER_SIZE > 256)
+#error "UART_RX_BUFFER_SIZE must be a power of two not more than 256"
+#endif
+#if ((UART_TX_BUFFER_SIZE & UART_TX_BUFFER_MASK) != 0) || (UART_TX_BUFFER_SIZE > 256)
+#error "UART_TX_BUFFER_SIZE must be a power of two not more than 256"
+#endif
+
+#ifndef NULL_PTR
+#define NULL_PTR (void *) 0
+#endif
+#endif
 
 /* -----------------------------------------------------------------------------
  *                      Functions Prototypes                                   *
 ------------------------------------------------------------------------------*/
 void UART_init(const Uart_ConfigType * Config_Ptr);
+bool UART_setBaudRate(const uint32 baudRate);
+uint32 UART_getSupportedBaudRate(const uint8 index);
+bool UART_isBaudRateSupported(const uint32 baudRate);
 
 void UART_sendByte(const uint8 data);
 void UART_sendString(const uint8 *Str);
 
-
-#ifdef POLLING_MODE
 uint8 UART_receiveByte(void);
 void UART_receiveString(uint8 *Str); // Receive until #
+
+#ifdef INTERRUPT_MODE
+/* Non-blocking access to the RX/TX ring buffers */
+uint8 UART_available(void);
+bool UART_read(uint8 *data);
+bool UART_write(const uint8 data);
+/* Asynchronous transmission of a whole buffer drained by the UDRE ISR, the
+ * buffer must stay unchanged until the call back function is called */
+bool UART_sendAsync(const uint8 *buffer,const uint8 length,void(*a_ptr)(void));
+bool UART_sendStringAsync(const uint8 *Str,void(*a_ptr)(void));
+bool UART_isTxBusy(void);
+/* Function called from the RXC ISR after every received byte */
+void UART_setRxCallBack(void(*a_ptr)(void));
+/* Bus master only: send the address byte before the next data bytes from
+ * the UDRE ISR, returns FALSE while the previous message is sent */
+bool UART_sendAddress(const uint8 address);
 #endif
 
 #endif
@@ -0,0 +1,29 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	frame_crc.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	CRC-8 of the Frame Protocol, apart from the UART code so
+					the trace decoder on the PC uses the same one
+------------------------------------------------------------------------------*/
+
+#include "frame.h"
+
+/* -----------------------------------------------------------------------------
+ *                      Functions Definitions                                  *
+ ------------------------------------------------------------------------------*/
+uint8 FRAME_crc8(uint8 crc,const uint8 data){
+	uint8 i;
+	crc ^= data;
+	for(i=0;i<8;i++){
+		if(crc & 0x80){
+			crc = (crc<<1) ^ FRAME_CRC_POLYNOMIAL;
+		}
+		else{
+			crc <<= 1;
+		}
+	}
+	return crc;
+}
@@ -8,65 +8,177 @@
 [DESCRIPTION]  :	Door Locker Security System, HMI responsible for
 					interfacing with the user
 ------------------------------------------------------------------------------*/
-#define F_CPU 8000000UL
 #include "LCD Driver/lcd.h"
 #include "Keypad Driver/keypad.h"
 #include "UART/uart.h"
+#include "Frame Protocol/frame.h"
+#include "Timer 2/timer2.h"
+#include "Important Heading Files/timer_config.h"
+#include "Power Manager/power.h"
 
-/* Random number to check if the control ECU is ready to receive
- * password or not*/
-#define CONTROL_ECU_READY 0xF0
+/* Size of the password array including the terminator (13)*/
+#define PASSWORD_SIZE 15
+#if (2*PASSWORD_SIZE > FRAME_MAX_PAYLOAD)
+#error "The password and its confirmation must fit in one frame"
+#endif
+/* Address of this HMI panel on the UART multi-processor bus, each panel
+ * connected to the Control ECU has its own address*/
+#define HMI_PANEL_ADDRESS 0x01
+/* Timer 2 interrupts every 10 ms to count the time awake and asleep and to
+ * wake the MC up for the next keypad scan*/
+#define TICKS_PER_SECOND 100
+/* Time waiting for FRAME_READY at each baud rate, longer than the period the
+ * Control ECU sends it to the panels which are not on the bus yet*/
+#define HMI_READY_TIMEOUT_TICKS (2*TICKS_PER_SECOND)
+/* Time waiting for Control ECU to confirm the selected baud rate once it is
+ * acknowledged, longer than the time Control ECU waits for all the panels*/
+#define HMI_BAUD_CONFIRM_TICKS (TICKS_PER_SECOND/2)
+/* Time waiting for a reply of Control ECU before a NACK is sent to get it
+ * again, and the NACKs sent before Control ECU is taken as not answering*/
+#define HMI_REPLY_TIMEOUT_TICKS TICKS_PER_SECOND
+#define HMI_REPLY_RETRIES 3
+/* Time waiting for RESET, longer than the lockout of Control ECU*/
+#define HMI_LOCKOUT_TIMEOUT_TICKS (65*TICKS_PER_SECOND)
+/* Time waiting for the next state of the door, longer than the travel
+ * timeout and the extended hold of Control ECU*/
+#define HMI_DOOR_TIMEOUT_TICKS (20*TICKS_PER_SECOND)
+/* Timer 2 counts of a tick and the time of a count in us, to measure the time
+ * asleep with TCNT2*/
+#define TICK_COUNTS (F_CPU/1024/TICKS_PER_SECOND)
+#define COUNT_US (1024000000UL/F_CPU)
+/* Bytes of a trace record in the FRAME_TRACE frames of Control ECU*/
+#define TRACE_RECORD_SIZE 9
+/* Global Variable to count the ticks since boot*/
+volatile uint32 g_ticks=0;
 /* Global Variable to store the received state of 2 password; matched or not*/
 volatile uint8 g_matchingCheck;
 /*2 Passwords States*/
 enum{UNMATCHED=1,MATCHED=2};
 /*Door States*/
-enum{OPEN,CHANGE,RESET,OPENED,CLOSED,CLOSING,DONE};
+enum{OPEN,CHANGE,RESET,OPENED,CLOSED,CLOSING,DONE,BUSY,OPENING,FAULT};
+/*State returned by receiveStatus when Control ECU does not answer*/
+#define NO_REPLY 0xFF
+/*Door Commands, the payload of FRAME_DOOR*/
+enum{COMMAND_OPEN,COMMAND_EXTEND_HOLD,COMMAND_STOP};
 /*Function used to get the password which consists of 6 digits from user*/
 void getPassword(uint8 * password);
-/*Function used to send the password to Control ECU using UART protocol*/
-void sendPassword(uint8 *password);
+/*Function used to get the length of password including the terminator*/
+uint8 passwordLength(const uint8 *password);
+/*Function used to send a command then each password digit to Control ECU
+ *as soon as it is entered by the user*/
+void streamPassword(uint8 command,uint8 *password);
+/*Function used to wait for a reply of one of two types sent by Control ECU,
+ *sending a NACK every timeout until it is received*/
+bool receiveReply(Frame_Type *frame,uint8 type,uint8 type_2,uint16 timeout);
+/*Function used to wait for a frame of one of two types sent by Control ECU*/
+bool receiveEitherFrame(Frame_Type *frame,uint8 type,uint8 type_2,\
+		uint16 timeout);
+/*Function used to switch to the baud rate selected by Control ECU*/
+bool joinBus(Frame_Type *frame);
+/*Function called every tick by the Timer 2 interrupt*/
+void tickCallBack(void);
+/*Function used to read the ticks since boot*/
+uint16 getTicks(void);
+/*Function used to read the time since boot in us*/
+uint32 getTimeUs(void);
+/*Function used to wait for a state sent by Control ECU in a status frame*/
+uint8 receiveStatus(uint16 timeout);
+/*Function used to wait for a state of the door while sending the door
+ *commands of the pressed keys*/
+uint8 receiveDoorStatus(Frame_Type *frame);
+/*Function to display a state of the door*/
+void displayDoorState(const Frame_Type *frame);
 /*Function used to take the password from the user and send it to Control ECU
  *to set it as password for the door used later to open the door*/
-void setPassword(uint8 *password);
+void setPassword(void);
 /*Function to communicate with Control ECU during opening the door*/
 void openDoor(uint8 *password);
 /*Function to communicate with Control ECU during changing the password*/
 void changePassword(uint8 *password);
+/*Function to display the time spent awake by Control ECU and HMI ECU*/
+void showPowerStats(void);
+/*Function to make Control ECU send its trace records on the bus*/
+void dumpTrace(void);
 
 int main(void){
-	volatile uint8 password[15];
-	uint8 key;
+	volatile uint8 password[PASSWORD_SIZE];
+	uint8 key,i=0;
+	Frame_Type frame;
 	Uart_ConfigType uart;
+	Timer2_ConfigType tick;
 	/*Setting the UART Configuration*/
-	uart.baudRate=9600;
-	uart.dataBits=UART_8_BIT;
+	uart.baudRate=UART_DEFAULT_BAUD;
+	uart.dataBits=UART_9_BIT;
 	uart.stopBits=UART_1_BIT;
 	uart.parityType=UART_DISABLE_PARITY;
+	uart.busMode=UART_BUS_SLAVE;
+	uart.address=HMI_PANEL_ADDRESS;
 	/*Initializing UART*/
 	UART_init(&uart);
-	/*Wait until Control ECU is ready to receive the data from HMI ECU*/
-	while(UART_receiveByte() != CONTROL_ECU_READY){}
+	FRAME_init();
+	/*Enable I-Bit for the UART RX/TX interrupts*/
+	SET_BIT(SREG,7);
+	/*Setting the Timer 2 Configurations to interrupt every tick, the MC
+	 * sleeps between the interrupts while it waits*/
+	tick.mode=TIMER2_CTC;
+	tick.clock=TIMER2_F_CPU_1024;
+	tick.initialValue=0;
+	tick.dutyCycle=0;
+	tick.oc2Mode=OC2_DISCONNECT;
+	tick.tick=TICK_COUNTS-1;
+#ifndef TIMER2_CTC_HANDLER
+	TIMER2_setCallBack(tickCallBack,TIMER2_CTC);
+#endif
+	TIMER2_init(&tick);
+	POWER_setClock(getTimeUs,TICK_COUNTS*COUNT_US);
+	/*Wait until Control ECU is ready to receive the data from HMI ECU. The
+	 * bus runs at another baud rate if Control ECU booted before this panel,
+	 * so each supported baud rate is tried in turn. Then offer the
+	 * supported baud rates and switch to the one selected by Control ECU,
+	 * if the switch is not confirmed start again from UART_DEFAULT_BAUD*/
+	do{
+		UART_setBaudRate(UART_DEFAULT_BAUD);
+		FRAME_flush();
+		i=0;
+		while(UART_getSupportedBaudRate(i)!=UART_DEFAULT_BAUD){
+			i++;
+		}
+		while(!receiveEitherFrame(&frame,FRAME_READY,FRAME_READY,\
+				HMI_READY_TIMEOUT_TICKS)){
+			i++;
+			if(UART_getSupportedBaudRate(i)==0){
+				i=0;
+			}
+			UART_setBaudRate(UART_getSupportedBaudRate(i));
+			FRAME_flush();
+		}
+		FRAME_offerBaudRates(HMI_PANEL_ADDRESS);
+	}while(!joinBus(&frame));
 	/*Initializing LCD*/
 	LCD_init();
-	setPassword(password);
+	setPassword();
 	while(1){
 		LCD_sendCommand(CLEAR_COMMAND);
 		/*Display the default message on the LCD*/
 		LCD_displayString("- : Open Door");
 		LCD_goToRowColumn(1,0);
 		LCD_displayString("+ : Change Pass");
-		/*Wait the user to choose if he want to open the door or change the password*/
+		/*Wait the user to choose if he want to open the door or change the
+		 * password, * shows the power statistics and % dumps the trace*/
 		key=KEYPAD_getPressedKey();
 		switch(key){
 		case '+':
-			UART_sendByte(CHANGE);
 			changePassword(password);
 			break;
 		case '-':
-			UART_sendByte(OPEN);
 			openDoor(password);
 			break;
+		case '*':
+			showPowerStats();
+			break;
+		case '%':
+			dumpTrace();
+			break;
 		}
 	}
 	return 0;
@@ -94,9 +206,8 @@ void changePassword(uint8 *password){
 	LCD_sendCommand(CLEAR_COMMAND);
 	LCD_displayString("Enter Old Pass:");
 	LCD_goToRowColumn(1,0);
-	getPassword(password);
-	sendPassword(password);
-	g_matchingCheck=UART_receiveByte();
+	streamPassword(FRAME_CHANGE_PASSWORD,password);
+	g_matchingCheck=receiveStatus(HMI_REPLY_TIMEOUT_TICKS);
 	while(((g_matchingCheck==UNMATCHED) & (n<2))){
 		n++;
 		LCD_sendCommand(CLEAR_COMMAND);
@@ -105,18 +216,28 @@ void changePassword(uint8 *password){
 		LCD_sendCommand(CLEAR_COMMAND);
 		LCD_displayString("Enter Old Pass:");
 		LCD_goToRowColumn(1,0);
-		getPassword(password);
-		sendPassword(password);
-		g_matchingCheck=UART_receiveByte();
+		streamPassword(FRAME_CHANGE_PASSWORD,password);
+		g_matchingCheck=receiveStatus(HMI_REPLY_TIMEOUT_TICKS);
 	}
 	if(n==2){
 		LCD_sendCommand(CLEAR_COMMAND);
 		LCD_displayString("Error !!!");
-		while(UART_receiveByte()!=RESET){};
+		do{
+			g_matchingCheck=receiveStatus(HMI_LOCKOUT_TIMEOUT_TICKS);
+		}while((g_matchingCheck!=RESET) && (g_matchingCheck!=NO_REPLY));
 	}
 	else if (g_matchingCheck==MATCHED){
-		setPassword(password);
-		while(UART_receiveByte()!=DONE){};
+		setPassword();
+		do{
+			g_matchingCheck=receiveStatus(HMI_REPLY_TIMEOUT_TICKS);
+		}while((g_matchingCheck!=DONE) && (g_matchingCheck!=NO_REPLY));
+	}
+	else{
+		/*Another panel is being served by Control ECU or it does not
+		 *answer*/
+		LCD_sendCommand(CLEAR_COMMAND);
+		LCD_displayString("System is busy");
+		_delay_ms(200);
 	}
 }
 
@@ -130,7 +251,9 @@ void changePassword(uint8 *password){
 				  entered the correct password The Control ECU will check and
 				  tell the HMI ECU that the password is correct then HMI ECU
 				  will display the state of the door sequentially (Opening,
-				  Opened, Closing)
+				  Opened with the time it took, Closing, Closed or Fault).
+				  While the door moves or is held open the user can press -
+				  to open it again, + to hold it open longer or = to stop it.
 
 [Args]		    :
 				in  -> point to array:
@@ -139,13 +262,13 @@ void changePassword(uint8 *password){
 				void
 ------------------------------------------------------------------------------*/
 void openDoor(uint8 *password){
-	uint8 n=0;
+	uint8 n=0,state;
+	Frame_Type frame;
 	LCD_sendCommand(CLEAR_COMMAND);
 	LCD_displayString("Enter Pass:");
 	LCD_goToRowColumn(1,0);
-	getPassword(password);
-	sendPassword(password);
-	g_matchingCheck=UART_receiveByte();
+	streamPassword(FRAME_OPEN_DOOR,password);
+	g_matchingCheck=receiveStatus(HMI_REPLY_TIMEOUT_TICKS);
 	while(((g_matchingCheck==UNMATCHED) & (n<2))){
 		n++;
 		LCD_sendCommand(CLEAR_COMMAND);
@@ -154,33 +277,84 @@ void openDoor(uint8 *password){
 		LCD_sendCommand(CLEAR_COMMAND);
 		LCD_displayString("Enter Pass:");
 		LCD_goToRowColumn(1,0);
-		getPassword(password);
-		sendPassword(password);
-		g_matchingCheck=UART_receiveByte();
+		streamPassword(FRAME_OPEN_DOOR,password);
+		g_matchingCheck=receiveStatus(HMI_REPLY_TIMEOUT_TICKS);
 	}
 	if(n==2){
 		LCD_sendCommand(CLEAR_COMMAND);
 		LCD_displayString("Thief !!!");
-		while(UART_receiveByte()!=RESET){};
+		do{
+			g_matchingCheck=receiveStatus(HMI_LOCKOUT_TIMEOUT_TICKS);
+		}while((g_matchingCheck!=RESET) && (g_matchingCheck!=NO_REPLY));
 	}
 	else if (g_matchingCheck==MATCHED){
+		/*Display each state as it is received, so a lost state is
+		 * skipped instead of blocking the sequence*/
+		do{
+			state=receiveDoorStatus(&frame);
+			displayDoorState(&frame);
+		}while((state!=CLOSED) && (state!=FAULT));
+		_delay_ms(200);
+	}
+	else{
+		/*Another panel is being served by Control ECU or it does not
+		 *answer*/
 		LCD_sendCommand(CLEAR_COMMAND);
+		LCD_displayString("System is busy");
+		_delay_ms(200);
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : displayDoorState
+[DESCRIPTION]   : Function is responsible for displaying a state of the door
+				  received from Control ECU with the keys of the door
+				  commands under it while the door moves or is held open.
+
+[Args]		    :
+				in  -> point to structure:
+						This argument is the status frame of the state,
+						OPENED carries the time to open in ms, LSB first.
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void displayDoorState(const Frame_Type *frame){
+	LCD_sendCommand(CLEAR_COMMAND);
+	switch(frame->payload[0]){
+	case OPENING:
 		LCD_displayString("Door is opening");
-		while(UART_receiveByte()!=OPENED){};
-		LCD_sendCommand(CLEAR_COMMAND);
-		LCD_displayString("Door is opened");
-		while(UART_receiveByte()!=CLOSING){};
-		LCD_sendCommand(CLEAR_COMMAND);
+		break;
+	case OPENED:
+		if(frame->length==3){
+			LCD_displayString("Opened: ");
+			LCD_intgerToString((int)(frame->payload[1]|\
+					((uint16)frame->payload[2]<<8)));
+			LCD_displayString(" ms");
+		}
+		else{
+			LCD_displayString("Door held open");
+		}
+		break;
+	case CLOSING:
 		LCD_displayString("Door is closing");
-		while(UART_receiveByte()!=CLOSED){};
+		break;
+	case CLOSED:
+		LCD_displayString("Door is closed");
+		return;
+	case FAULT:
+		LCD_displayString("Door stopped !");
+		return;
 	}
+	LCD_goToRowColumn(1,0);
+	LCD_displayString("-Open +Hold =Stp");
 }
 
 /* ---------------------------------------------------------------------------
 [FUNCTION NAME] : getPassword
 [DESCRIPTION]   : This function is responsible for taking the password from
 				  the user digit by digit and store them in array and display
-				  '*' on LCD instead of each entered digit.
+				  '*' on LCD instead of each entered digit. The digits after
+				  PASSWORD_SIZE-1 are dropped until Enter is pressed.
 
 [Args]		    :
 				in  -> point to array:
@@ -192,82 +366,524 @@ void getPassword(uint8 * password){
 	uint8 i=0,key;
 	_delay_ms(100);
 	key=KEYPAD_getPressedKey();
-	while(key!=13){
+	while((key!=13) && (i<PASSWORD_SIZE-1)){
 		password[i]=key;
 		i++;
 		LCD_displayString("*");
 		_delay_ms(100);
 		key=KEYPAD_getPressedKey();
 	}
+	/*Wait for Enter if the password is too long*/
+	while(key!=13){
+		_delay_ms(100);
+		key=KEYPAD_getPressedKey();
+	}
 	password[i]=key;
 }
 
 /* ---------------------------------------------------------------------------
-[FUNCTION NAME] : sendPassword
-[DESCRIPTION]   : Function is responsible for sending the password (which is
-				  entered from the user) to Control ECU
+[FUNCTION NAME] : passwordLength
+[DESCRIPTION]   : Function is responsible for counting the password bytes
+				  including the terminator (13).
 
 [Args]		    :
 				in  -> point to array:
 						This argument is array includes the password.
 [Return]	   :
-				void
+				out -> length of the password including the terminator
 ------------------------------------------------------------------------------*/
-void sendPassword(uint8 *password){
+uint8 passwordLength(const uint8 *password){
 	uint8 i=0;
 	while(password[i]!=13){
-		UART_sendByte(password[i]);
 		i++;
 	}
-	UART_sendByte(password[i]);
+	return i+1;
 }
 
 /* ---------------------------------------------------------------------------
-[FUNCTION NAME] : setPassword
-[DESCRIPTION]   : Function is responsible for taking the password twice from
-				  the user and send them to Control ECU to check if the two
-				  passwords are matched or not. If the two passwords are not
-				  matched the HMI ECU will repeat the process and take the two
-				  passwords again from the user.
+[FUNCTION NAME] : streamPassword
+[DESCRIPTION]   : Function is responsible for sending a command to Control
+				  ECU then taking the password from the user digit by digit
+				  and sending each digit once it is entered, so Control ECU
+				  checks the password while it is typed and its reply is ready
+				  once Enter (13) is sent. Any old state still waiting in the
+				  receive buffer is dropped first so it is not taken as a reply
+				  to this command.
 
 [Args]		    :
+				in  -> uint8:
+						This argument is the command frame type.
 				in  -> point to array:
 						This argument is empty array to store the password.
 [Return]	   :
 				void
 ------------------------------------------------------------------------------*/
-void setPassword(uint8 *password){
+void streamPassword(uint8 command,uint8 *password){
+	uint8 i=0,key;
+	FRAME_flush();
+	/*Command without password, the digits follow in FRAME_DIGIT frames*/
+	FRAME_send(HMI_PANEL_ADDRESS,command,NULL_PTR,0);
+	_delay_ms(100);
+	key=KEYPAD_getPressedKey();
+	while((key!=13) && (i<PASSWORD_SIZE-1)){
+		password[i]=key;
+		i++;
+		FRAME_send(HMI_PANEL_ADDRESS,FRAME_DIGIT,&key,1);
+		LCD_displayString("*");
+		_delay_ms(100);
+		key=KEYPAD_getPressedKey();
+	}
+	/*Wait for Enter if the password is too long*/
+	while(key!=13){
+		_delay_ms(100);
+		key=KEYPAD_getPressedKey();
+	}
+	password[i]=key;
+	FRAME_send(HMI_PANEL_ADDRESS,FRAME_DIGIT,&key,1);
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : receiveStatus
+[DESCRIPTION]   : Function is responsible for waiting for a state sent by
+				  Control ECU in a status frame. If a corrupted frame is
+				  received or no frame is received in time, a NACK is sent
+				  to make Control ECU send the last frame again.
+
+[Args]		    :
+				in  -> uint16:
+						This argument is the timeout in ticks before each
+						NACK.
+[Return]	   :
+				out -> the received state, NO_REPLY if Control ECU does
+					   not answer
+------------------------------------------------------------------------------*/
+uint8 receiveStatus(uint16 timeout){
+	Frame_Type frame;
+	do{
+		if(!receiveReply(&frame,FRAME_STATUS,FRAME_STATUS,timeout)){
+			return NO_REPLY;
+		}
+	}while(frame.length!=1);
+	return frame.payload[0];
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : receiveDoorStatus
+[DESCRIPTION]   : Function is responsible for waiting for a state of the door
+				  sent by Control ECU in a status frame. Meanwhile the keypad
+				  is scanned every tick and a door command is sent once for
+				  every press of - (OPEN), + (EXTEND_HOLD) or = (STOP). A
+				  NACK is sent when no state is received in time, and the
+				  door is shown as FAULT once Control ECU does not answer.
+
+[Args]		    :
+				out -> point to structure:
+						This argument is the received status frame.
+[Return]	   :
+				uint8:
+						The state of the door.
+------------------------------------------------------------------------------*/
+uint8 receiveDoorStatus(Frame_Type *frame){
+	Frame_Status status;
+	uint8 key,command;
+	uint8 lastKey=KEYPAD_NO_KEY;
+	uint8 retries=0;
+	uint16 start=getTicks();
+	while(1){
+		status=FRAME_receive(frame);
+		if((status==FRAME_COMPLETE) && (frame->type==FRAME_STATUS) &&\
+				(frame->length!=0) &&\
+				((frame->address==HMI_PANEL_ADDRESS) ||\
+				(frame->address==UART_BROADCAST_ADDRESS))){
+			return frame->payload[0];
+		}
+		else if(status==FRAME_CORRUPTED){
+			FRAME_send(HMI_PANEL_ADDRESS,FRAME_NACK,NULL_PTR,0);
+		}
+		else if((status==FRAME_COMPLETE) && (frame->type==FRAME_NACK) &&\
+				(frame->address==HMI_PANEL_ADDRESS)){
+			/*Control ECU received a corrupted frame, send the last one
+			 *again*/
+			FRAME_resend(HMI_PANEL_ADDRESS);
+		}
+		if(status!=FRAME_INCOMPLETE){
+			continue;
+		}
+		if((uint16)(getTicks()-start)>=HMI_DOOR_TIMEOUT_TICKS){
+			if(retries==HMI_REPLY_RETRIES){
+				frame->type=FRAME_STATUS;
+				frame->length=1;
+				frame->payload[0]=FAULT;
+				return FAULT;
+			}
+			/*The state is lost, make Control ECU send it again*/
+			FRAME_send(HMI_PANEL_ADDRESS,FRAME_NACK,NULL_PTR,0);
+			retries++;
+			start=getTicks();
+		}
+		key=KEYPAD_getKey();
+		if(key!=lastKey){
+			command=(key=='-') ? COMMAND_OPEN : (key=='+') ?\
+					COMMAND_EXTEND_HOLD : (key=='=') ? COMMAND_STOP : 0xFF;
+			if(command!=0xFF){
+				FRAME_send(HMI_PANEL_ADDRESS,FRAME_DOOR,&command,1);
+				/*The command can hold the door open longer*/
+				start=getTicks();
+			}
+			lastKey=key;
+		}
+		/*Sleep until the next tick or the next received byte*/
+		CLEAR_BIT(SREG,7);
+		if(UART_available()==0){
+			POWER_sleep(POWER_IDLE);
+		}
+		else{
+			SET_BIT(SREG,7);
+		}
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : receiveReply
+[DESCRIPTION]   : Function is responsible for waiting for a reply of one of
+				  two types sent by Control ECU to this panel or to all
+				  panels. If no reply is received in time a NACK is sent to
+				  make Control ECU send the last frame again, up to
+				  HMI_REPLY_RETRIES times.
+
+[Args]		    :
+				out -> point to structure:
+						This argument is a frame to store the received frame,
+						its type is FRAME_NACK if no reply is received.
+				in  -> uint8:
+						This argument is the first accepted frame type.
+				in  -> uint8:
+						This argument is the second accepted frame type.
+				in  -> uint16:
+						This argument is the timeout in ticks before each
+						NACK.
+[Return]	   :
+				out -> TRUE if the reply is received, FALSE if Control ECU
+					   does not answer
+------------------------------------------------------------------------------*/
+bool receiveReply(Frame_Type *frame,uint8 type,uint8 type_2,uint16 timeout){
+	uint8 retries;
+	for(retries=0;retries<HMI_REPLY_RETRIES;retries++){
+		if(receiveEitherFrame(frame,type,type_2,timeout)){
+			return TRUE;
+		}
+		FRAME_send(HMI_PANEL_ADDRESS,FRAME_NACK,NULL_PTR,0);
+	}
+	if(receiveEitherFrame(frame,type,type_2,timeout)){
+		return TRUE;
+	}
+	frame->type=FRAME_NACK;
+	frame->length=0;
+	return FALSE;
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : receiveEitherFrame
+[DESCRIPTION]   : Function is responsible for waiting for a frame of one of
+				  two types sent by Control ECU to this panel or to all
+				  panels. If a corrupted frame is received, a NACK is sent to
+				  make Control ECU send the last frame again, and a NACK of
+				  Control ECU is answered by sending the last frame again.
+				  The MC sleeps until the next byte or the next tick.
+
+[Args]		    :
+				out -> point to structure:
+						This argument is a frame to store the received frame.
+				in  -> uint8:
+						This argument is the first accepted frame type.
+				in  -> uint8:
+						This argument is the second accepted frame type.
+				in  -> uint16:
+						This argument is the timeout in ticks.
+[Return]	   :
+				out -> TRUE if the frame is received, FALSE on timeout
+------------------------------------------------------------------------------*/
+bool receiveEitherFrame(Frame_Type *frame,uint8 type,uint8 type_2,\
+		uint16 timeout){
+	Frame_Status status;
+	uint16 start=getTicks();
+	while(1){
+		status=FRAME_receive(frame);
+		if(status==FRAME_INCOMPLETE){
+			if((uint16)(getTicks()-start)>=timeout){
+				return FALSE;
+			}
+			CLEAR_BIT(SREG,7);
+			if(UART_available()==0){
+				POWER_sleep(POWER_IDLE);
+			}
+			else{
+				SET_BIT(SREG,7);
+			}
+		}
+		else if((status==FRAME_COMPLETE) &&\
+				((frame->type==type) || (frame->type==type_2)) &&\
+				((frame->address==HMI_PANEL_ADDRESS) ||\
+				(frame->address==UART_BROADCAST_ADDRESS))){
+			return TRUE;
+		}
+		else if((status==FRAME_CORRUPTED) && (type!=FRAME_READY)){
+			/*Before FRAME_READY the panel can run at another baud rate than
+			 *the bus, so it only listens*/
+			FRAME_send(HMI_PANEL_ADDRESS,FRAME_NACK,NULL_PTR,0);
+		}
+		else if((status==FRAME_COMPLETE) && (frame->type==FRAME_NACK) &&\
+				(frame->address==HMI_PANEL_ADDRESS)){
+			/*Control ECU received a corrupted frame, send the last one
+			 *again*/
+			FRAME_resend(HMI_PANEL_ADDRESS);
+		}
+	}
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : setPassword
+[DESCRIPTION]   : Function is responsible for taking the password twice from
+				  the user and send them to Control ECU in one frame to check
+				  if the two passwords are matched or not. If the two passwords
+				  are not matched the HMI ECU will repeat the process and take
+				  the two passwords again from the user.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void setPassword(void){
+	uint8 passwords[2*PASSWORD_SIZE];
+	uint8 n;
 	LCD_sendCommand(CLEAR_COMMAND);
 	LCD_displayString("Enter New Pass:");
 	LCD_goToRowColumn(1,0);
-	getPassword(password);
-	sendPassword(password);
+	getPassword(passwords);
+	n=passwordLength(passwords);
 	LCD_sendCommand(CLEAR_COMMAND);
 	LCD_displayString("Reenter New Pass");
 	LCD_goToRowColumn(1,0);
-	getPassword(password);
-	sendPassword(password);
-	g_matchingCheck=UART_receiveByte();
+	getPassword(passwords+n);
+	FRAME_flush();
+	/*The frame waits for room while the queue is sent in the background,
+	 *the two passwords always fit in the payload*/
+	while(!FRAME_send(HMI_PANEL_ADDRESS,FRAME_SET_PASSWORD,passwords,\
+			n+passwordLength(passwords+n))){}
+	g_matchingCheck=receiveStatus(HMI_REPLY_TIMEOUT_TICKS);
 	LCD_sendCommand(CLEAR_COMMAND);
 	/*Check from the Control ECU if 2 entered password is matched or not*/
-	while(g_matchingCheck==UNMATCHED){
-		/*as long as the 2 entered password is not matched display error on LCD
-		 * and repeat setting password for first time*/
+	while((g_matchingCheck==UNMATCHED) || (g_matchingCheck==NO_REPLY)){
+		/*as long as the 2 entered password is not matched or not answered
+		 * display error on LCD and repeat setting password for first time*/
 		LCD_displayString("Error Try again");
 		_delay_ms(200);  /*Displaying time for error message*/
 		LCD_sendCommand(CLEAR_COMMAND);
 		LCD_displayString("Enter New Pass:");
 		LCD_goToRowColumn(1,0);
-		getPassword(password);
-		sendPassword(password);
+		getPassword(passwords);
+		n=passwordLength(passwords);
 		LCD_sendCommand(CLEAR_COMMAND);
 		LCD_displayString("Reenter New Pass");
 		LCD_goToRowColumn(1,0);
-		getPassword(password);
-		sendPassword(password);
-		g_matchingCheck=UART_receiveByte();
+		getPassword(passwords+n);
+		FRAME_flush();
+		while(!FRAME_send(HMI_PANEL_ADDRESS,FRAME_SET_PASSWORD,passwords,\
+				n+passwordLength(passwords+n))){}
+		g_matchingCheck=receiveStatus(HMI_REPLY_TIMEOUT_TICKS);
 		LCD_sendCommand(CLEAR_COMMAND);	}
-	/*If the 2 entered passwords are matched display successful */
-	LCD_displayString("Successful !");
+	/*If the 2 entered passwords are matched display successful, BUSY means
+	 * the password is already set from another panel */
+	if(g_matchingCheck==BUSY){
+		LCD_displayString("Pass already set");
+	}
+	else{
+		LCD_displayString("Successful !");
+	}
 	_delay_ms(200);
 }
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : showPowerStats
+[DESCRIPTION]   : Function is responsible for asking Control ECU for the
+				  time it spent awake and displaying it with the time spent
+				  awake by this HMI ECU as percentages of the time since boot
+				  until any key is pressed.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void showPowerStats(void){
+	Frame_Type frame;
+	uint32 awake,asleep;
+	uint8 i;
+	FRAME_flush();
+	FRAME_send(HMI_PANEL_ADDRESS,FRAME_POWER,NULL_PTR,0);
+	receiveReply(&frame,FRAME_POWER,FRAME_STATUS,HMI_REPLY_TIMEOUT_TICKS);
+	LCD_sendCommand(CLEAR_COMMAND);
+	if((frame.type==FRAME_POWER) && (frame.length==8)){
+		awake=0;
+		asleep=0;
+		for(i=0;i<4;i++){
+			awake|=((uint32)frame.payload[i])<<(8*i);
+			asleep|=((uint32)frame.payload[4+i])<<(8*i);
+		}
+		LCD_displayString("Control awake:");
+		LCD_intgerToString((awake+asleep<100) ? 0 :\
+				(int)(awake/((awake+asleep)/100)));
+		LCD_displayString("%");
+	}
+	else{
+		/*Another panel is being served by Control ECU or it does not
+		 *answer*/
+		LCD_displayString("System is busy");
+	}
+	POWER_getStats(&awake,&asleep);
+	LCD_goToRowColumn(1,0);
+	LCD_displayString("HMI awake:");
+	LCD_intgerToString((awake+asleep<100) ? 0 :\
+			(int)(awake/((awake+asleep)/100)));
+	LCD_displayString("%");
+	_delay_ms(100);
+	KEYPAD_getPressedKey();
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : dumpTrace
+[DESCRIPTION]   : Function is responsible for asking Control ECU for its
+				  trace records. They are sent on the bus in FRAME_TRACE
+				  frames to be captured from the UART lines and decoded on a
+				  PC, this function only waits for the empty frame ending
+				  them and displays the number of records sent.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void dumpTrace(void){
+	Frame_Type frame;
+	uint16 records=0;
+	FRAME_flush();
+	FRAME_send(HMI_PANEL_ADDRESS,FRAME_TRACE,NULL_PTR,0);
+	do{
+		receiveReply(&frame,FRAME_TRACE,FRAME_STATUS,HMI_REPLY_TIMEOUT_TICKS);
+		if(frame.type==FRAME_TRACE){
+			records+=frame.length/TRACE_RECORD_SIZE;
+		}
+	}while((frame.type==FRAME_TRACE) && (frame.length!=0));
+	LCD_sendCommand(CLEAR_COMMAND);
+	if(frame.type==FRAME_TRACE){
+		LCD_displayString("Trace records:");
+		LCD_goToRowColumn(1,0);
+		LCD_intgerToString(records);
+	}
+	else{
+		/*Another panel is being served by Control ECU*/
+		LCD_displayString("System is busy");
+	}
+	_delay_ms(100);
+	KEYPAD_getPressedKey();
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : joinBus
+[DESCRIPTION]   : Function is responsible for switching to the baud rate
+				  selected by Control ECU once the baud rates are offered.
+				  The switch is acknowledged by sending the select frame back
+				  at the new baud rate and it is kept only once Control ECU
+				  confirms it with the select frame. A baud rate which is
+				  not supported is not acknowledged, so Control ECU goes back
+				  to UART_DEFAULT_BAUD too.
+
+[Args]		    :
+				out -> point to structure:
+						This argument is a frame to store the received frames.
+[Return]	   :
+				out -> TRUE if the panel is on the bus, FALSE if it must
+					   wait for FRAME_READY again
+------------------------------------------------------------------------------*/
+bool joinBus(Frame_Type *frame){
+	uint32 baudRate;
+	if(!receiveEitherFrame(frame,FRAME_BAUD_SELECT,FRAME_BAUD_SELECT,\
+			HMI_READY_TIMEOUT_TICKS)){
+		return FALSE;
+	}
+	baudRate=FRAME_applyBaudRate(frame);
+	if(baudRate==0){
+		return FALSE;
+	}
+	FRAME_sendBaudRate(HMI_PANEL_ADDRESS,baudRate);
+	return receiveEitherFrame(frame,FRAME_BAUD_SELECT,FRAME_BAUD_SELECT,\
+			HMI_BAUD_CONFIRM_TICKS);
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : tickCallBack
+[DESCRIPTION]   : Function is responsible for counting the ticks since boot
+				  for the timeouts and the power statistics, it is called
+				  every tick by the Timer 2 interrupt.
+
+[Args]		    :
+				void
+[Return]	   :
+				void
+------------------------------------------------------------------------------*/
+void tickCallBack(void){
+	g_ticks++;
+	POWER_tick();
+	/*The tick wakes up the waiting loops, which drop a frame once it
+	 *times out*/
+	FRAME_tick();
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : getTicks
+[DESCRIPTION]   : Function is responsible for reading the ticks since boot,
+				  the bytes are read with the I-bit cleared. The low 16 bits
+				  are enough for the timeouts.
+
+[Args]		    :
+				void
+[Return]	   :
+				out -> the ticks since boot
+------------------------------------------------------------------------------*/
+uint16 getTicks(void){
+	uint16 ticks;
+	uint8 sreg=SREG;
+	CLEAR_BIT(SREG,7);
+	ticks=(uint16)g_ticks;
+	SREG=sreg;
+	return ticks;
+}
+
+/* ---------------------------------------------------------------------------
+[FUNCTION NAME] : getTimeUs
+[DESCRIPTION]   : Function is responsible for reading the time since boot in
+				  us from the ticks and TCNT2, it is the clock which measures
+				  the time asleep. It wraps every 71 minutes.
+
+[Args]		    :
+				void
+[Return]	   :
+				out -> the time since boot in us
+------------------------------------------------------------------------------*/
+uint32 getTimeUs(void){
+	uint32 ticks;
+	uint8 counts;
+	uint8 sreg=SREG;
+	CLEAR_BIT(SREG,7);
+	ticks=g_ticks;
+	counts=TCNT2;
+	if(BIT_IS_SET(TIFR,OCF2)){
+		/*TCNT2 matched and the ISR did not count the tick yet, read it again
+		 *as it may have been read before the match*/
+		ticks++;
+		counts=TCNT2;
+	}
+	SREG=sreg;
+	return (ticks*(TICK_COUNTS*COUNT_US))+(counts*COUNT_US);
+}
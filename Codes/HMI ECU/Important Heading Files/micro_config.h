@@ -12,7 +12,7 @@
 #define MC_CONFIG_H
 
 #ifndef F_CPU
-#define F_CPU 1000000UL  //1MHz Clock frequency
+#define F_CPU 8000000UL  //8MHz Clock frequency of both ECUs
 #endif  
 
 #include <avr/io.h>
@@ -0,0 +1,25 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	timer_config.h
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Handlers of the HMI ECU bound statically to the timer
+					interrupts
+------------------------------------------------------------------------------*/
+
+#ifndef TIMER_CONFIG_H
+#define TIMER_CONFIG_H
+
+/* The ISR of a vector whose handler is named here calls it directly and
+ * TIMER2_setCallBack is ignored for it. Comment the line of a vector to set
+ * its callback at run time again. The cycles of both bindings are counted in
+ * timer_config.h of the Control ECU.
+ */
+
+/* Timer 2, the tick of the HMI ECU */
+/* #define TIMER2_OVF_HANDLER */
+#define TIMER2_CTC_HANDLER tickCallBack
+
+#endif
@@ -9,6 +9,7 @@
 ------------------------------------------------------------------------------*/
 
 #include "KEYPAD.h"
+#include "../Power Manager/power.h"
 
 /* -----------------------------------------------------------------------------
  *                      Functions Prototypes(Private)                          *
@@ -33,36 +34,50 @@ static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
  ------------------------------------------------------------------------------*/
 uint8 KEYPAD_getPressedKey(void)
 {
-	uint8 col,row;
+	uint8 key;
 	while(1)
 	{
-		for(col=0;col<N_col;col++) /* loop for columns */
+		key = KEYPAD_getKey();
+		if(key != KEYPAD_NO_KEY)
 		{
-			/* 
-			 * each time only one of the column pins will be output and 
-			 * the rest will be input pins include the row pins 
-			 */ 
-			KEYPAD_PORT_DIR = (0b00010000<<col); 
-			
-			/* 
-			 * clear the output pin column in this trace and enable the internal 
-			 * pull up resistors for the rows pins
-			 */ 
-			KEYPAD_PORT_OUT = (~(0b00010000<<col));
+			return key;
+		}
+		/* No key is pressed, sleep until the next tick interrupt */
+		CLEAR_BIT(SREG,7);
+		POWER_sleep(POWER_IDLE);
+	}	
+}
 
-			for(row=0;row<N_row;row++) /* loop for rows */
+uint8 KEYPAD_getKey(void)
+{
+	uint8 col,row;
+	for(col=0;col<N_col;col++) /* loop for columns */
+	{
+		/* 
+		 * each time only one of the column pins will be output and 
+		 * the rest will be input pins include the row pins 
+		 */ 
+		KEYPAD_PORT_DIR = (0b00010000<<col); 
+		
+		/* 
+		 * clear the output pin column in this trace and enable the internal 
+		 * pull up resistors for the rows pins
+		 */ 
+		KEYPAD_PORT_OUT = (~(0b00010000<<col));
+
+		for(row=0;row<N_row;row++) /* loop for rows */
+		{
+			if(BIT_IS_CLEAR(KEYPAD_PORT_IN,row)) /* if the switch is press in this row */ 
 			{
-				if(BIT_IS_CLEAR(KEYPAD_PORT_IN,row)) /* if the switch is press in this row */ 
-				{
-					#if (N_col == 3)
-						return KEYPAD_4x3_adjustKeyNumber((row*N_col)+col+1);
-					#elif (N_col == 4)
-						return KEYPAD_4x4_adjustKeyNumber((row*N_col)+col+1);
-					#endif
-				}
+				#if (N_col == 3)
+					return KEYPAD_4x3_adjustKeyNumber((row*N_col)+col+1);
+				#elif (N_col == 4)
+					return KEYPAD_4x4_adjustKeyNumber((row*N_col)+col+1);
+				#endif
 			}
 		}
-	}	
+	}
+	return KEYPAD_NO_KEY;
 }
 
 #if (N_col == 3) 
@@ -28,13 +28,23 @@
 #define KEYPAD_PORT_IN  PINB
 #define KEYPAD_PORT_DIR DDRB
 
+/* Returned by KEYPAD_getKey when no key is pressed */
+#define KEYPAD_NO_KEY 0xFF
+
 /* -----------------------------------------------------------------------------
  *                      Functions Prototypes                                   *
 /* ---------------------------------------------------------------------------*/
 
 /*
- * Function responsible for getting the pressed keypad key
+ * Function responsible for getting the pressed keypad key, the MC sleeps
+ * between the scans so a periodic timer interrupt must be running
  */
 uint8 KEYPAD_getPressedKey(void);
 
+/*
+ * Function responsible for scanning the keypad once, it returns the pressed
+ * key or KEYPAD_NO_KEY without waiting
+ */
+uint8 KEYPAD_getKey(void);
+
 #endif
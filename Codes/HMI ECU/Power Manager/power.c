@@ -0,0 +1,79 @@
+/* -----------------------------------------------------------------------------
+[FILE NAME]    :	power.c
+
+[AUTHOR]       :	MOHANAD K. SAEED
+
+[DATA CREATED] :	17/10/2026
+
+[DESCRIPTION]  :	Power Manager
+------------------------------------------------------------------------------*/
+
+#include "power.h"
+#include <avr/sleep.h>
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+static uint32 (*volatile g_clockPtr)(void) = NULL_PTR;
+static uint32 g_tickUs=1;
+static volatile uint32 g_ticks=0;
+/* Time asleep measured around the sleep instruction, in whole ticks and the
+ * us left below a tick. They are only written by POWER_sleep */
+static volatile uint32 g_asleepTicks=0;
+static uint32 g_asleepUs=0;
+
+/* ----------------------------------------------------------------------------
+ *                      Functions Definitions                                 *
+------------------------------------------------------------------------------*/
+void POWER_sleep(Power_Mode mode)
+{
+	uint32 start=0;
+	MCUCR = (MCUCR & NUM_TO_CLEAR_SLEEP_BITS) | mode | (1<<SE);
+	if(g_clockPtr != NULL_PTR)
+	{
+		start = (*g_clockPtr)();
+	}
+	/* The instruction after SEI is executed before any pending interrupt, so
+	 * the MC sleeps first and the interrupt wakes it up */
+	sei();
+	sleep_cpu();
+	CLEAR_BIT(MCUCR,SE);
+	if(g_clockPtr != NULL_PTR)
+	{
+		/* The ISR which woke the MC up is counted asleep, it is short. The MC
+		 * wakes up every tick so the loop runs once at most in most cases */
+		g_asleepUs += (*g_clockPtr)() - start;
+		while(g_asleepUs >= g_tickUs)
+		{
+			g_asleepUs -= g_tickUs;
+			g_asleepTicks++;
+		}
+	}
+}
+
+void POWER_tick(void)
+{
+	g_ticks++;
+}
+
+void POWER_setClock(uint32(*a_clock)(void),uint32 tickUs)
+{
+	g_tickUs = tickUs;
+	g_clockPtr = a_clock;
+}
+
+void POWER_getStats(uint32 *awakeTicks,uint32 *asleepTicks)
+{
+	uint32 ticks;
+	uint8 sreg = SREG;
+	CLEAR_BIT(SREG,7);
+	ticks = g_ticks;
+	SREG = sreg;
+	*asleepTicks = g_asleepTicks;
+	/* The sleep which is not counted by the tick yet is dropped */
+	if(*asleepTicks > ticks)
+	{
+		*asleepTicks = ticks;
+	}
+	*awakeTicks = ticks - *asleepTicks;
+}
@@ -10,17 +10,140 @@
 
 #include "UART.h"
 
+/* -----------------------------------------------------------------------------
+ *                         Types Declaration                                   *
+ ------------------------------------------------------------------------------*/
+typedef struct{
+	uint32 baudRate;
+	uint16 ubrr;
+}Uart_BaudEntry;
+
+/* ----------------------------------------------------------------------------
+ *                          Global Variables                                  *
+------------------------------------------------------------------------------*/
+/* Baud rates which can be generated from F_CPU with no more than 2% error,
+ * fastest first. UBRR values are computed at compile time */
+static const Uart_BaudEntry g_baudTable[] = {
+#if UART_BAUD_IS_VALID(1000000UL)
+	{1000000UL,UART_UBRR(1000000UL)},
+#endif
+#if UART_BAUD_IS_VALID(500000UL)
+	{500000UL,UART_UBRR(500000UL)},
+#endif
+#if UART_BAUD_IS_VALID(250000UL)
+	{250000UL,UART_UBRR(250000UL)},
+#endif
+#if UART_BAUD_IS_VALID(115200UL)
+	{115200UL,UART_UBRR(115200UL)},
+#endif
+#if UART_BAUD_IS_VALID(57600UL)
+	{57600UL,UART_UBRR(57600UL)},
+#endif
+#if UART_BAUD_IS_VALID(38400UL)
+	{38400UL,UART_UBRR(38400UL)},
+#endif
+#if UART_BAUD_IS_VALID(19200UL)
+	{19200UL,UART_UBRR(19200UL)},
+#endif
+	{UART_DEFAULT_BAUD,UART_UBRR(UART_DEFAULT_BAUD)}
+};
+#define UART_BAUD_TABLE_SIZE (sizeof(g_baudTable)/sizeof(g_baudTable[0]))
+
 #ifdef INTERRUPT_MODE
+/* Write 1 to TXC to clear it without touching the other UCSRA flags, then
+ * wait for the new TXC to know when this byte is shifted out */
+#define UART_CLEAR_TXC() \
+	do{ UCSRA = (UCSRA & UART_UCSRA_WRITE_MASK) | (1<<TXC); g_txPending = TRUE; }while(0)
+
 /* ----------------------------------------------------------------------------
  *                          Global Variables                                  *
 ------------------------------------------------------------------------------*/
-volatile uint8  g_uartReceivedData;
+/* RX ring buffer: written by the RXC ISR (head), read by the application (tail) */
+static volatile uint8 g_rxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 g_rxHead=0;
+static volatile uint8 g_rxTail=0;
+/* TX ring buffer: written by the application (head), read by the UDRE ISR (tail) */
+static volatile uint8 g_txBuffer[UART_TX_BUFFER_SIZE];
+static volatile uint8 g_txHead=0;
+static volatile uint8 g_txTail=0;
+/* Asynchronous transfer: buffer owned by the application, sent before the
+ * TX ring buffer bytes which are written after the transfer started */
+static const uint8 * volatile g_txAsyncPtr;
+static volatile uint8 g_txAsyncLength=0;
+/* A byte was written to UDR and TXC was not seen yet */
+static volatile bool g_txPending=FALSE;
+/* Address byte sent by the UDRE ISR with the 9th bit set before the next
+ * data bytes */
+static volatile uint8 g_txAddress;
+static volatile bool g_txAddressPending=FALSE;
+/* Multi-processor bus mode and the address of this slave */
+static Uart_BusMode g_busMode=UART_POINT_TO_POINT;
+static uint8 g_address;
+static void (* volatile g_txCallBackPtr)(void) = NULL_PTR;
+static void (* volatile g_rxCallBackPtr)(void) = NULL_PTR;
 
 /* ----------------------------------------------------------------------------
  *                          ISR's Definitions                                 *
 	------------------------------------------------------------------------------*/
 ISR(USART_RXC_vect){
-	g_uartReceivedData = UDR;
+	/* RXB8 must be read before UDR */
+	uint8 ninthBit = BIT_IS_SET(UCSRB,RXB8);
+	uint8 data = UDR;
+	uint8 next = (g_rxHead+1) & UART_RX_BUFFER_MASK;
+	if((g_busMode == UART_BUS_SLAVE) && ninthBit){
+		/* Address byte: receive the next data bytes only if they are for
+		 * this slave, otherwise let the hardware drop them (MPCM = 1).
+		 * UCSRA is written directly so TXC is not cleared by mistake */
+		if((data == g_address) || (data == UART_BROADCAST_ADDRESS)){
+			UCSRA = (UCSRA & (1<<U2X));
+		}
+		else{
+			UCSRA = (UCSRA & (1<<U2X)) | (1<<MPCM);
+		}
+		return;
+	}
+	/* If the buffer is full the new byte is dropped, the application must
+	 * drain the buffer faster or increase UART_RX_BUFFER_SIZE */
+	if(next != g_rxTail){
+		g_rxBuffer[g_rxHead] = data;
+		g_rxHead = next;
+	}
+	if(g_rxCallBackPtr != NULL_PTR){
+		(*g_rxCallBackPtr)();
+	}
+}
+
+ISR(USART_UDRE_vect){
+	if(g_txAddressPending){
+		/* UDR is empty so the previous byte is in the shift register with
+		 * its own 9th bit. TXB8 must be written before UDR */
+		SET_BIT(UCSRB,TXB8);
+		UDR = g_txAddress;
+		UART_CLEAR_TXC();
+		g_txAddressPending = FALSE;
+		return;
+	}
+	/* Once the address is in the shift register the next bytes are data */
+	CLEAR_BIT(UCSRB,TXB8);
+	if(g_txAsyncLength != 0){
+		UDR = *g_txAsyncPtr;
+		UART_CLEAR_TXC();
+		g_txAsyncPtr++;
+		g_txAsyncLength--;
+		if((g_txAsyncLength == 0) && (g_txCallBackPtr != NULL_PTR)){
+			/* The last byte is in UDR, the application buffer is free now */
+			(*g_txCallBackPtr)();
+		}
+	}
+	else if(g_txTail != g_txHead){
+		UDR = g_txBuffer[g_txTail];
+		UART_CLEAR_TXC();
+		g_txTail = (g_txTail+1) & UART_TX_BUFFER_MASK;
+	}
+	else{
+		/* Nothing left to send, disable the UDRE interrupt until the next write */
+		CLEAR_BIT(UCSRB,UDRIE);
+	}
 }
 #endif
 
@@ -29,11 +152,14 @@ ISR(USART_RXC_vect){
 ------------------------------------------------------------------------------*/
 void UART_init(const Uart_ConfigType * Config_Ptr)
 {
-	/*Calculating Baud-rate pre-scaler*/
-	uint16 ubrr=(F_CPU/((Config_Ptr -> baudRate)*8UL))-1;
-	/* U2X = 1 for double transmission speed */
-	SET_BIT(UCSRA,U2X);
-	CLEAR_BIT(UCSRA,MPCM);
+	/* U2X = 1 for double transmission speed
+	 * MPCM = 1 for a bus slave to wait for its address byte */
+	if(Config_Ptr -> busMode == UART_BUS_SLAVE){
+		UCSRA = (1<<U2X) | (1<<MPCM);
+	}
+	else{
+		UCSRA = (1<<U2X);
+	}
 
 	/*-------------------------- UCSRB Description ----------------------------
 	 * RXCIE = 0 Disable UART RX Complete Interrupt Enable
@@ -41,12 +167,20 @@ void UART_init(const Uart_ConfigType * Config_Ptr)
 	 * UDRIE = 0 Disable UART Data Register Empty Interrupt Enable
 	 * RXEN  = 1 Receiver Enable
 	 * RXEN  = 1 Transmitter Enable
-	 * UCSZ2 = 0 For 8-bit data mode
-	 * RXB8 & TXB8 not used for 8-bit data mode
+	 * UCSZ2 = 0 For 8-bit data mode, 1 For 9-bit data mode
+	 * RXB8 & TXB8 9th bit, 1 for an address byte in bus modes
 	 ------------------------------------------------------------------------*/
 	UCSRB = (1<<RXEN) | (1<<TXEN);
 
 #ifdef INTERRUPT_MODE
+	/* Start with empty ring buffers and enable the RX Complete Interrupt,
+	 * the UDRE interrupt is enabled only while there is data to send */
+	g_rxHead = g_rxTail = 0;
+	g_txHead = g_txTail = 0;
+	g_txAsyncLength = 0;
+	g_txPending = FALSE;
+	g_busMode = Config_Ptr -> busMode;
+	g_address = Config_Ptr -> address;
 	SET_BIT(UCSRB,RXCIE);
 #endif
 	UCSRB = (UCSRB & NUM_TO_CLEAR_2ND_BIT) |\
@@ -74,13 +208,65 @@ void UART_init(const Uart_ConfigType * Config_Ptr)
 	}
 	CLEAR_BIT(UCSRC,UCPOL);
 
+	/* Baud rates with more than 2% error are refused, use the default one */
+	if(!UART_setBaudRate(Config_Ptr -> baudRate)){
+		UART_setBaudRate(UART_DEFAULT_BAUD);
+	}
+}
+
+bool UART_setBaudRate(const uint32 baudRate)
+{
+	uint8 i;
+	for(i=0;i<UART_BAUD_TABLE_SIZE;i++){
+		if(g_baudTable[i].baudRate == baudRate){
+			break;
+		}
+	}
+	if(i == UART_BAUD_TABLE_SIZE){
+		return FALSE;
+	}
+	/* Wait until the last byte is shifted out with the old baud rate */
+#ifdef INTERRUPT_MODE
+	while(UART_isTxBusy() || g_txAddressPending){}
+	if(g_txPending){
+		while(BIT_IS_CLEAR(UCSRA,TXC)){}
+		g_txPending = FALSE;
+	}
+#else
+	while(BIT_IS_CLEAR(UCSRA,UDRE)){}
+#endif
 	/* First 8 bits from the BAUD_PRESCALE inside UBRRL and last 4 bits in UBRRH*/
-	UBRRH = ubrr>>8;
-	UBRRL = ubrr;
+	UBRRH = g_baudTable[i].ubrr>>8;
+	UBRRL = g_baudTable[i].ubrr;
+	return TRUE;
+}
+
+uint32 UART_getSupportedBaudRate(const uint8 index)
+{
+	/* The table is sorted fastest first, 0 marks the end of the table */
+	if(index >= UART_BAUD_TABLE_SIZE){
+		return 0;
+	}
+	return g_baudTable[index].baudRate;
+}
+
+bool UART_isBaudRateSupported(const uint32 baudRate)
+{
+	uint8 i;
+	for(i=0;i<UART_BAUD_TABLE_SIZE;i++){
+		if(g_baudTable[i].baudRate == baudRate){
+			return TRUE;
+		}
+	}
+	return FALSE;
 }
 
 void UART_sendByte(const uint8 data)
 {
+#ifdef INTERRUPT_MODE
+	/* Wait until there is a free place in the TX ring buffer */
+	while(!UART_write(data)){}
+#else
 	/* UDRE flag is set when the Tx buffer (UDR) is empty and ready for 
 	 * transmitting a new byte so wait until this flag is set to one */
 	while(BIT_IS_CLEAR(UCSRA,UDRE)){}
@@ -92,6 +278,7 @@ void UART_sendByte(const uint8 data)
 	while(BIT_IS_CLEAR(UCSRA,TXC)){} // Wait until the transimission is complete TXC = 1
 	SET_BIT(UCSRA,TXC); // Clear the TXC flag
 	-----------------------------------------------------------------*/
+#endif
 }
 
 void UART_sendString(const uint8 *Str)
@@ -111,15 +298,21 @@ void UART_sendString(const uint8 *Str)
 	-----------------------------------------------------------------*/
 }
 
-#ifdef POLLING_MODE
 uint8 UART_receiveByte(void)
 {
+#ifdef INTERRUPT_MODE
+	uint8 data;
+	/* Wait until the RXC ISR puts a byte in the RX ring buffer */
+	while(!UART_read(&data)){}
+	return data;
+#else
 	/* RXC flag is set when the UART receive data so wait until this
 	 * flag is set to one */
 	while(BIT_IS_CLEAR(UCSRA,RXC)){}
 	/* Read the received data from the Rx buffer (UDR) and the RXC flag
 	   will be cleared after read this data */
 	return UDR;
+#endif
 }
 
 void UART_receiveString(uint8 *Str)
@@ -133,4 +326,92 @@ void UART_receiveString(uint8 *Str)
 	}
 	Str[i] = '\0';
 }
+
+#ifdef INTERRUPT_MODE
+uint8 UART_available(void)
+{
+	/* The indices are 8-bit so they are read atomically */
+	return (g_rxHead - g_rxTail) & UART_RX_BUFFER_MASK;
+}
+
+bool UART_read(uint8 *data)
+{
+	if(g_rxHead == g_rxTail){
+		return FALSE;
+	}
+	*data = g_rxBuffer[g_rxTail];
+	g_rxTail = (g_rxTail+1) & UART_RX_BUFFER_MASK;
+	return TRUE;
+}
+
+bool UART_write(const uint8 data)
+{
+	uint8 next = (g_txHead+1) & UART_TX_BUFFER_MASK;
+	if(next == g_txTail){
+		return FALSE;
+	}
+	g_txBuffer[g_txHead] = data;
+	g_txHead = next;
+	/* Let the UDRE ISR drain the TX ring buffer */
+	SET_BIT(UCSRB,UDRIE);
+	return TRUE;
+}
+
+bool UART_sendAsync(const uint8 *buffer,const uint8 length,void(*a_ptr)(void))
+{
+	/* Only one transfer at a time and only after the TX ring buffer is
+	 * drained, to keep the bytes in the same order they are sent */
+	if(UART_isTxBusy()){
+		return FALSE;
+	}
+	if(length == 0){
+		if(a_ptr != NULL_PTR){
+			(*a_ptr)();
+		}
+		return TRUE;
+	}
+	g_txAsyncPtr = buffer;
+	g_txCallBackPtr = a_ptr;
+	/* The length is set last as the UDRE ISR starts sending once it is not 0 */
+	g_txAsyncLength = length;
+	SET_BIT(UCSRB,UDRIE);
+	return TRUE;
+}
+
+bool UART_sendStringAsync(const uint8 *Str,void(*a_ptr)(void))
+{
+	uint8 length = 0;
+	while(Str[length] != '\0')
+	{
+		length++;
+	}
+	return UART_sendAsync(Str,length,a_ptr);
+}
+
+void UART_setRxCallBack(void(*a_ptr)(void))
+{
+	g_rxCallBackPtr = a_ptr;
+}
+
+bool UART_isTxBusy(void)
+{
+	return (g_txAsyncLength != 0) || (g_txHead != g_txTail);
+}
+
+bool UART_sendAddress(const uint8 address)
+{
+	if(g_busMode != UART_BUS_MASTER){
+		return TRUE;
+	}
+	/* The address goes before the bytes written after it, so the data bytes
+	 * of the previous message must have left the buffers */
+	if(UART_isTxBusy() || g_txAddressPending){
+		return FALSE;
+	}
+	g_txAddress = address;
+	g_txAddressPending = TRUE;
+	/* The UDRE ISR sends it with the 9th bit once UDR is empty */
+	SET_BIT(UCSRB,UDRIE);
+	return TRUE;
+}
 #endif